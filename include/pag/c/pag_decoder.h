@@ -45,4 +45,32 @@ PAG_API bool pag_decoder_read_frame(pag_decoder* decoder, int index, void* pixel
 PAG_API bool pag_decoder_read_frame_to_hardware_buffer(pag_decoder* decoder, int index,
                                                        void* buffer);
 
+/**
+ * Reads frameCount frames starting at startIndex and advancing frameStride frames each step into a
+ * single caller-owned block of memory, the i-th frame is written at (pixels + i * frameBytes).
+ * The decoder is locked only once for the whole range. Returns the number of frames read
+ * successfully.
+ */
+PAG_API int pag_decoder_read_frames(pag_decoder* decoder, int startIndex, int frameCount,
+                                    int frameStride, void* pixels, size_t rowBytes,
+                                    size_t frameBytes, pag_color_type colorType,
+                                    pag_alpha_type alphaType);
+
+/**
+ * Borrows a read-only view of the frame at the given index from a buffer owned by the decoder.
+ * Borrows of the same index, colorType and alphaType share the same buffer and are not decoded or
+ * copied again, unless the composition has been edited since then. The row bytes of the returned
+ * pixels are written into rowBytes. Returns nullptr if failed. Every successful call must be
+ * balanced by a call to pag_decoder_release_frame(), and all views must be released before the
+ * decoder is released.
+ */
+PAG_API const void* pag_decoder_acquire_frame(pag_decoder* decoder, int index,
+                                              pag_color_type colorType, pag_alpha_type alphaType,
+                                              size_t* rowBytes);
+
+/**
+ * Returns a view obtained from pag_decoder_acquire_frame() to the decoder.
+ */
+PAG_API void pag_decoder_release_frame(pag_decoder* decoder, const void* pixels);
+
 PAG_C_PLUS_PLUS_END_GUARD
@@ -2501,6 +2501,14 @@ class PAG_API File {
 
   bool hasScaledTimeRange() const;
 
+  /**
+   * Evaluates all animatable properties of the file over their keyframe ranges into lookup tables,
+   * after which evaluating them becomes an indexed load instead of keyframe interpolation. It is
+   * useful for files played in a loop for a long time. The tables can not be released until the
+   * file is destroyed. Returns the total number of bytes used by the tables.
+   */
+  size_t bakeTimeline();
+
   /**
    * Indicates how to stretch the duration of File when rendering.
    */
@@ -2508,6 +2516,11 @@ class PAG_API File {
   TimeRange scaledTimeRange = {};
   FileAttributes fileAttributes = {};
   std::string path = "";
+  /**
+   * A hash of the bytes the file was decoded from. It tells the contents apart even if a file is
+   * replaced by another one at the same path.
+   */
+  uint64_t contentHash = 0;
   std::vector<ImageBytes*> images;
   std::vector<Composition*> compositions;
 
@@ -2528,6 +2541,8 @@ class PAG_API File {
   // Just references, no need to delete them.
   std::vector<std::vector<ImageLayer*>> imageLayers = {};
 
+  std::mutex bakeLocker = {};
+
   File(std::vector<Composition*> compositionList, std::vector<pag::ImageBytes*> imageList);
   void updateEditables(Composition* composition);
 
@@ -2541,6 +2556,12 @@ class PAG_API File {
  */
 int64_t PAG_API CalculateGraphicsMemory(std::shared_ptr<File> file);
 
+/**
+ * Calculate the memory cost by graphics of each frame of the file in bytes, indexed by the frames
+ * of the root composition. The maximum value is the same as CalculateGraphicsMemory().
+ */
+std::vector<int64_t> PAG_API CalculateGraphicsMemoriesPerFrame(std::shared_ptr<File> file);
+
 class CodecContext;
 
 class PAG_API Codec {
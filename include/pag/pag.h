@@ -985,6 +985,7 @@ class PAG_API PAGComposition : public PAGLayer {
                          std::shared_ptr<PAGLayer> pagLayer);
   static void MeasureChildLayer(tgfx::Rect* bounds, PAGLayer* childLayer);
   static void DrawChildLayer(Recorder* recorder, PAGLayer* childLayer);
+  static bool CanRecordConcurrently(PAGLayer* childLayer);
   static bool GetTrackMatteLayerAtPoint(PAGLayer* childLayer, float x, float y,
                                         std::vector<std::shared_ptr<PAGLayer>>* results);
   static bool GetChildLayerAtPoint(PAGLayer* childLayer, float x, float y,
@@ -997,6 +998,7 @@ class PAG_API PAGComposition : public PAGLayer {
   void doSetLayerIndex(std::shared_ptr<PAGLayer> pagLayer, int index);
   bool doContains(PAGLayer* layer) const;
   void updateDurationAndFrameRate();
+  void drawChildLayers(Recorder* recorder);
 
   friend class PAGLayer;
 
@@ -1125,6 +1127,32 @@ class PAG_API PAGFile : public PAGComposition {
    */
   std::shared_ptr<PAGFile> copyOriginal();
 
+  /**
+   * Decodes the images embedded in the file in parallel ahead of rendering, so that the first
+   * frames do not stall on image decoding. The images are decoded at the size they are displayed
+   * at when the file is drawn at its original size, and they are adopted by the first PAGPlayer
+   * that renders them. The decoded images not adopted within 5 seconds are freed. This method
+   * blocks until all images are decoded or the timeout expires.
+   * @param duration Only the images visible within the first duration of the original file
+   * timeline (in microseconds) are decoded. Passing a value less than or equal to 0 decodes all
+   * images.
+   * @param timeout The maximum time to wait (in microseconds). The images not yet started when the
+   * timeout expires are skipped. Passing a value less than or equal to 0 waits for all images.
+   * @return true if all images are decoded. Returns false without decoding anything if the
+   * predicted graphics memory of the file does not fit in the PAGMemoryBudget, the caller may try
+   * again later.
+   */
+  bool preload(int64_t duration = 0, int64_t timeout = 0);
+
+  /**
+   * Evaluates all animatable properties of the file in advance into lookup tables, so that
+   * rendering later frames skips the keyframe interpolation. It is intended for files played in a
+   * loop for a long time, such as stickers and badges. The tables are shared by all PAGFiles
+   * loaded from the same file and stay alive until the file is released. Returns the number of
+   * bytes used by the tables.
+   */
+  size_t bakeTimeline();
+
   bool isPAGFile() const override;
 
  protected:
@@ -1168,6 +1196,8 @@ class PAGPlayer;
 
 class GLRestorer;
 
+class FrameSnapshotHolder;
+
 class PAG_API PAGSurface {
  public:
   /**
@@ -1282,7 +1312,45 @@ class PAG_API PAGSurface {
   friend class PAGSurfaceExt;
 };
 
+/**
+ * The process-wide budget of graphics memory shared by all PAGPlayers. The graphics memory of each
+ * PAGFile is predicted from its content by CalculateGraphicsMemoriesPerFrame(). Every player that
+ * flushes is registered as active, and players already active stay active when a budget is set.
+ * A player that starts flushing while a budget is set is admitted only if the predicted peak memory
+ * of all active players fits in the budget. Otherwise flush() returns false without drawing and
+ * PAGPlayer.memoryBudgetAdmitted() returns false until a later flush() is admitted. Players release
+ * their budget when their composition or surface is removed, or when they have not flushed for two
+ * seconds. When the memory of the upcoming frame would exceed the budget, the caches of the least
+ * recently flushed players are purged at their next flush(). PAGFile.preload() reserves the
+ * predicted memory of the file while decoding and is refused if it does not fit in the budget.
+ * The players used internally by PAGDecoder are not managed by the budget and never refused.
+ */
+class PAG_API PAGMemoryBudget {
+ public:
+  /**
+   * Returns the budget of graphics memory in bytes. 0 means unlimited, which is the default value.
+   */
+  static int64_t Budget();
+
+  /**
+   * Sets the budget of graphics memory in bytes. Values less than or equal to 0 mean unlimited.
+   * The players already active are not affected.
+   */
+  static void SetBudget(int64_t bytes);
+
+  /**
+   * Returns the sum of the predicted peak graphics memory of all active players in bytes.
+   */
+  static int64_t PredictedUsage();
+
+  /**
+   * Returns the number of active players.
+   */
+  static size_t ActivePlayers();
+};
+
 class FileReporter;
+class FrameBudgetGovernor;
 
 class PAG_API PAGPlayer {
  public:
@@ -1347,6 +1415,34 @@ class PAG_API PAGPlayer {
    */
   void setUseDiskCache(bool value);
 
+  /**
+   * The maximum number of video frames decoded ahead of the current frame on a background thread
+   * while playing forward. Values greater than 1 help to avoid dropping frames when some frames
+   * take longer to decode than others, but cost extra memory for each decoded frame. It only takes
+   * effect on video decoders that can keep multiple decoded frames alive, such as the software
+   * decoders. The default value is 1.
+   */
+  int videoDecodeAheadFrames();
+
+  /**
+   * Set the value of videoDecodeAheadFrames property.
+   */
+  void setVideoDecodeAheadFrames(int value);
+
+  /**
+   * If set to true, PAGPlayer records the independent child layers of each composition into
+   * separate graphics on worker threads and stitches them together in z-order. This can reduce the
+   * CPU time of each frame for compositions with many complex child layers. The child layers that
+   * depend on edited content are always recorded on the calling thread, and the final output is
+   * the same as sequential recording. The default value is false.
+   */
+  bool parallelRecordingEnabled();
+
+  /**
+   * Set the value of parallelRecordingEnabled property.
+   */
+  void setParallelRecordingEnabled(bool value);
+
   /**
    * This value defines the scale factor for internal graphics caches, ranges from 0.0 to 1.0. The
    * scale factors less than 1.0 may result in blurred output, but it can reduce the usage of
@@ -1371,6 +1467,34 @@ class PAG_API PAGPlayer {
    */
   void setMaxFrameRate(float value);
 
+  /**
+   * Returns the time budget of a frame in microseconds. 0 means the frame budget governor is
+   * disabled. The default value is 0.
+   */
+  int64_t frameBudget();
+
+  /**
+   * Sets the time budget of a frame in microseconds and enables the frame budget governor. When the
+   * renderingTime plus the presentingTime of several consecutive frames exceeds the budget, the
+   * player lowers the rendering quality step by step, see PAGQualityLevel. The quality is restored
+   * step by step once the frames are well within the budget again. The cacheScale() and
+   * maxFrameRate() still return the values set by the caller. Setting a value less than or equal to
+   * 0 disables the governor and restores the full quality.
+   */
+  void setFrameBudget(int64_t budget);
+
+  /**
+   * Returns the current quality level chosen by the frame budget governor, see PAGQualityLevel.
+   */
+  int qualityLevel();
+
+  /**
+   * Sets a callback to be notified with the new quality level when the frame budget governor
+   * changes it. The callback is invoked on the thread calling flush() with the internal lock held,
+   * so it should not call back into the player.
+   */
+  void setQualityLevelCallback(std::function<void(int qualityLevel)> callback);
+
   /**
    * Returns the current scale mode.
    */
@@ -1460,6 +1584,14 @@ class PAG_API PAGPlayer {
   /**
    * Apply all pending changes to the target surface immediately. Returns true if the content has
    * changed.
+   *
+   * While flush() is drawing on one thread, the following getters called on other threads return
+   * the values evaluated at the beginning of the frame instead of waiting for the drawing to
+   * finish: maxFrameRate(), scaleMode(), matrix(), duration(), getProgress(), currentFrame(),
+   * autoClear(), renderingTime(), imageDecodingTime(), presentingTime() and graphicsMemory(). All
+   * other methods, including getBounds(), getLayersUnderPoint(), hitTestPoint(), the methods of the
+   * PAGLayers in the player, and the PAGDecoders sharing the composition, still wait for the
+   * drawing to finish.
    */
   bool flush();
 
@@ -1527,6 +1659,19 @@ class PAG_API PAGPlayer {
    */
   int64_t graphicsMemory();
 
+  /**
+   * The memory cost by graphics of the current frame in bytes predicted from the content, which
+   * can be compared with graphicsMemory(). Returns 0 if the composition is not a PAGFile.
+   */
+  int64_t predictedGraphicsMemory();
+
+  /**
+   * Returns false if the last flush() was refused by the PAGMemoryBudget because the predicted
+   * graphics memory of the player does not fit in the budget beside other active players. The
+   * refused player draws nothing until it is admitted by a later flush().
+   */
+  bool memoryBudgetAdmitted();
+
  protected:
   std::shared_ptr<std::mutex> rootLocker = nullptr;
   std::shared_ptr<PAGStage> stage = nullptr;
@@ -1540,6 +1685,14 @@ class PAG_API PAGPlayer {
 
  private:
   FileReporter* reporter = nullptr;
+  FrameSnapshotHolder* snapshotHolder = nullptr;
+  FrameBudgetGovernor* governor = nullptr;
+  std::function<void(int)> qualityLevelCallback = nullptr;
+  std::vector<int64_t> memoryPredictions = {};
+  int64_t predictedPeakMemory = 0;
+  bool memoryPredicted = false;
+  bool memoryAdmitted = true;
+  bool memoryBudgetExempt = false;
   float _maxFrameRate = 60;
   int _scaleMode = PAGScaleMode::LetterBox;
   bool _autoClear = true;
@@ -1549,8 +1702,15 @@ class PAG_API PAGPlayer {
   int64_t getTimeStampInternal();
   void prepareInternal();
   int64_t durationInternal();
+  void applyQualityLevel();
+  void updateMemoryPrediction();
+  int64_t predictedMemoryInternal();
+  bool checkMemoryBudget();
+  void releaseMemoryBudget();
 
   friend class PAGSurface;
+
+  friend class CompositionReader;
 };
 
 class SequenceFile;
@@ -1626,6 +1786,19 @@ class PAG_API PAGDecoder {
    */
   bool readFrame(int index, HardwareBufferRef hardwareBuffer);
 
+  /**
+   * Reads pixels of frameCount image frames into the specified memory address, starting at
+   * startIndex and advancing frameStride frames each step. The i-th frame read is written at
+   * (pixels + i * frameBytes), where frameBytes must be at least rowBytes * height(). Frames that
+   * fall into the same static time range as the previous one are copied from the previous output
+   * instead of being decoded again. Returns the number of frames read successfully, reading stops
+   * at the first failure. The same restrictions on colorType, alphaType, and rowBytes apply as in
+   * readFrame().
+   */
+  int readFrames(int startIndex, int frameCount, int frameStride, void* pixels, size_t rowBytes,
+                 size_t frameBytes, ColorType colorType = ColorType::RGBA_8888,
+                 AlphaType alphaType = AlphaType::Premultiplied);
+
  private:
   std::mutex locker = {};
   int _width = 0;
@@ -1639,6 +1812,11 @@ class PAG_API PAGDecoder {
   std::shared_ptr<PAGComposition> container = nullptr;
   std::shared_ptr<SequenceFile> sequenceFile = nullptr;
   std::shared_ptr<CompositionReader> reader = nullptr;
+  int pendingIndex = -1;
+  std::shared_ptr<BitmapBuffer> pendingBitmap = nullptr;
+  std::shared_ptr<SequenceFile> previousSequenceFile = nullptr;
+  std::vector<TimeRange> changedTimeRanges = {};
+  std::unordered_map<ID, uint32_t> layerVersions = {};
   std::vector<TimeRange> staticTimeRanges = {};
   std::function<std::string(PAGDecoder*, std::shared_ptr<PAGComposition>)> cacheKeyGeneratorFun =
       nullptr;
@@ -1646,18 +1824,30 @@ class PAG_API PAGDecoder {
   static Composition* GetSingleComposition(std::shared_ptr<PAGComposition> pagComposition);
   static std::pair<int, float> GetFrameCountAndRate(std::shared_ptr<PAGComposition> pagComposition,
                                                     float maxFrameRate);
-  static std::vector<TimeRange> GetStaticTimeRange(std::shared_ptr<PAGComposition> composition,
-                                                   int numFrames);
+  static std::vector<TimeRange> AnalyzeStaticTimeRange(std::shared_ptr<PAGComposition> composition,
+                                                       int numFrames);
 
   PAGDecoder(std::shared_ptr<PAGComposition> composition, int width, int height, int numFrames,
              float frameRate, float maxFrameRate);
 
-  bool readFrameInternal(int index, std::shared_ptr<BitmapBuffer> bitmap);
+  bool readFrameInternal(int index, std::shared_ptr<BitmapBuffer> bitmap, int nextIndex = -1,
+                         std::shared_ptr<BitmapBuffer> nextBitmap = nullptr);
   bool renderFrame(std::shared_ptr<PAGComposition> composition, int index,
                    std::shared_ptr<BitmapBuffer> bitmap);
+  void renderFrameAsync(std::shared_ptr<PAGComposition> composition, int index,
+                        std::shared_ptr<BitmapBuffer> bitmap);
+  bool waitPendingFrame();
   bool checkSequenceFile(std::shared_ptr<PAGComposition> composition, const tgfx::ImageInfo& info);
   void checkCompositionChange(std::shared_ptr<PAGComposition> composition);
+  bool collectChangedTimeRanges(PAGLayer* layer, PAGLayer* root,
+                                std::vector<TimeRange>* timeRanges) const;
+  bool getLayerTimeRange(PAGLayer* layer, PAGLayer* root, TimeRange* timeRange) const;
+  void recordLayerVersions(PAGLayer* layer);
+  bool readPreviousFrame(int index, std::shared_ptr<BitmapBuffer> bitmap);
+  bool hasPreviousFrame(int index);
   std::string generateCacheKey(std::shared_ptr<PAGComposition> composition);
+  std::string staticTimeRangesCacheKey(std::shared_ptr<PAGComposition> composition);
+  std::vector<TimeRange> getStaticTimeRanges(std::shared_ptr<PAGComposition> composition);
   std::shared_ptr<PAGComposition> getComposition();
   void setCacheKeyGeneratorFun(
       std::function<std::string(PAGDecoder*, std::shared_ptr<PAGComposition>)> fun);
@@ -1703,6 +1893,22 @@ class PAG_API PAGVideoDecoder {
    * decoding video sequences from a pag file, if hardware decoders are not available.
    */
   static void RegisterSoftwareDecoderFactory(SoftwareDecoderFactory* decoderFactory);
+
+  /**
+   * Set the maximum number of idle video decoders that PAG keeps for reusing. When a video
+   * sequence is no longer rendered, its decoder is flushed and kept for a few seconds, a new video
+   * sequence with the same format takes it over instead of creating a new one. Set it to 0 to
+   * disable the decoder pooling. The default value is 4.
+   */
+  static void SetMaxPooledDecoderCount(int count);
+
+  /**
+   * Set the number of threads used by each built-in software video decoder (libavc), which splits
+   * the decoding of a frame into parsing, reconstruction and deblocking stages running in parallel.
+   * It helps with large video compositions when no hardware decoder is available. The value
+   * ranges from 1 to 4, and only affects decoders created afterward. The default value is 1.
+   */
+  static void SetSoftwareDecoderThreadCount(int count);
 };
 
 class PAG_API PAG {
@@ -1412,6 +1412,30 @@ class PAG_API PAGScaleMode {
   static const Enum Zoom = 3;
 };
 
+/**
+ * Defines the rendering quality levels chosen by the frame budget governor of PAGPlayer. Each level
+ * includes the degradations of the levels below it.
+ */
+class PAG_API PAGQualityLevel {
+ public:
+  /**
+   * Renders with full quality. This is the default value.
+   */
+  static const Enum Full = 0;
+  /**
+   * The scale factor for internal graphics caches is reduced.
+   */
+  static const Enum LowCacheScale = 1;
+  /**
+   * Expensive filters such as motion blur and large glows are skipped.
+   */
+  static const Enum NoExpensiveFilters = 2;
+  /**
+   * The maximum frame rate for rendering is halved.
+   */
+  static const Enum LowFrameRate = 3;
+};
+
 /**
  * Defines the rules on how to stretch the timeline of content to fit the specified duration.
  */
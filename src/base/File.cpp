@@ -19,6 +19,7 @@
 #include "pag/file.h"
 #include <algorithm>
 #include <unordered_map>
+#include "base/keyframes/BakeableProperty.h"
 
 namespace pag {
 
@@ -93,6 +94,28 @@ void File::updateEditables(Composition* composition) {
   }
 }
 
+size_t File::bakeTimeline() {
+  std::lock_guard<std::mutex> autoLock(bakeLocker);
+  // Keyframes beyond the longest composition are rarely visible, skip them to bound the memory.
+  Frame maxFrames = 1;
+  BakeablePropertyCollector collector = {};
+  for (auto composition : compositions) {
+    maxFrames = std::max(maxFrames, composition->duration + 1);
+    if (composition->type() != CompositionType::Vector) {
+      continue;
+    }
+    std::vector<TimeRange> timeRanges = {{0, composition->duration - 1}};
+    for (auto layer : static_cast<VectorComposition*>(composition)->layers) {
+      layer->excludeVaryingRanges(&timeRanges);
+    }
+  }
+  size_t totalBytes = 0;
+  for (auto property : collector.properties()) {
+    totalBytes += property->bake(maxFrames);
+  }
+  return totalBytes;
+}
+
 int64_t File::duration() const {
   return mainComposition->duration;
 }
@@ -20,6 +20,8 @@
 
 #include "base/keyframes/MultiDimensionPoint3DKeyframe.h"
 #include "base/keyframes/MultiDimensionPointKeyframe.h"
+#include "base/keyframes/PackedAnimatableProperty.h"
+#include "base/keyframes/PathKeyframe.h"
 #include "base/keyframes/SingleEaseKeyframe.h"
 #include "base/keyframes/SpatialPoint3DKeyframe.h"
 #include "base/keyframes/SpatialPointKeyframe.h"
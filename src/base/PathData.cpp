@@ -143,6 +143,8 @@ void PathData::interpolate(const PathData& path, PathData* result, float t) {
   int indexA = 0;
   int indexB = 0;
   auto size = verbsA.size();
+  result->verbs.reserve(result->verbs.size() + size);
+  result->points.reserve(result->points.size() + std::max(pointsA.size(), pointsB.size()));
   for (size_t i = 0; i < size; i++) {
     auto verbA = verbsA[i];
     auto verbB = verbsB[i];
@@ -0,0 +1,37 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BakeableProperty.h"
+
+namespace pag {
+static thread_local BakeablePropertyCollector* CurrentCollector = nullptr;
+
+BakeablePropertyCollector::BakeablePropertyCollector() : previous(CurrentCollector) {
+  CurrentCollector = this;
+}
+
+BakeablePropertyCollector::~BakeablePropertyCollector() {
+  CurrentCollector = previous;
+}
+
+void BakeablePropertyCollector::Collect(BakeableProperty* property) {
+  if (CurrentCollector != nullptr) {
+    CurrentCollector->_properties.insert(property);
+  }
+}
+}  // namespace pag
@@ -0,0 +1,70 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <unordered_set>
+#include "pag/file.h"
+
+namespace pag {
+/**
+ * BakeableProperty is an animatable property that can evaluate all of its values in advance, after
+ * which getValueAt() becomes an indexed load from the baked table.
+ */
+class BakeableProperty {
+ public:
+  virtual ~BakeableProperty() = default;
+
+  /**
+   * Evaluates the values of every frame between the first and the last keyframes into a table.
+   * Properties spanning more than maxFrames frames or holding non-trivial values (paths, gradients,
+   * text documents) are not baked. Returns the number of bytes used by the table, or 0 if the
+   * property is not baked. Calling it again returns the size of the existing table.
+   */
+  virtual size_t bake(Frame maxFrames) = 0;
+};
+
+/**
+ * Collects the bakeable properties reached by excludeVaryingRanges() on the current thread while
+ * the collector is alive. Walking the layers of a file this way finds every property that may
+ * change its content, so the decoder does not need to keep a list of them.
+ */
+class BakeablePropertyCollector {
+ public:
+  BakeablePropertyCollector();
+
+  ~BakeablePropertyCollector();
+
+  BakeablePropertyCollector(const BakeablePropertyCollector&) = delete;
+
+  BakeablePropertyCollector& operator=(const BakeablePropertyCollector&) = delete;
+
+  /**
+   * Adds the property to the collector of the current thread, does nothing if there is none.
+   */
+  static void Collect(BakeableProperty* property);
+
+  const std::unordered_set<BakeableProperty*>& properties() const {
+    return _properties;
+  }
+
+ private:
+  BakeablePropertyCollector* previous = nullptr;
+  std::unordered_set<BakeableProperty*> _properties = {};
+};
+}  // namespace pag
@@ -0,0 +1,108 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "base/keyframes/BakeableProperty.h"
+#include "pag/file.h"
+
+namespace pag {
+/**
+ * Returns the size of a keyframe slot in the packed storage, every slot is aligned as if it was
+ * allocated by the new operator.
+ */
+inline size_t PackedKeyframeSize(size_t keyframeSize) {
+  static constexpr size_t Alignment = alignof(std::max_align_t);
+  return (keyframeSize + Alignment - 1) / Alignment * Alignment;
+}
+
+/**
+ * PackedAnimatableProperty is an AnimatableProperty whose keyframes are constructed in one
+ * contiguous memory block owned by the property, which is used by the decoder to avoid a heap
+ * allocation for each keyframe and to keep the keyframes close to each other during evaluation.
+ */
+template <typename T>
+class PackedAnimatableProperty : public AnimatableProperty<T>, public BakeableProperty {
+ public:
+  PackedAnimatableProperty(const std::vector<Keyframe<T>*>& keyframes,
+                           std::unique_ptr<uint8_t[]> storage)
+      : AnimatableProperty<T>(keyframes), storage(std::move(storage)) {
+  }
+
+  ~PackedAnimatableProperty() override {
+    for (auto& keyframe : this->keyframes) {
+      keyframe->~Keyframe<T>();
+    }
+    // The keyframes are not allocated by the new operator, clear them before the base destructor
+    // deletes them.
+    this->keyframes.clear();
+    delete[] bakedValues.load();
+  }
+
+  void excludeVaryingRanges(std::vector<TimeRange>* timeRanges) const override {
+    // The walk is read-only for everyone except the thread baking the timeline of the file.
+    BakeablePropertyCollector::Collect(const_cast<PackedAnimatableProperty<T>*>(this));
+    AnimatableProperty<T>::excludeVaryingRanges(timeRanges);
+  }
+
+  T getValueAt(Frame frame) override {
+    auto values = bakedValues.load(std::memory_order_acquire);
+    if (values == nullptr) {
+      return AnimatableProperty<T>::getValueAt(frame);
+    }
+    // Frames outside the keyframes are clamped to the first or the last value, which is also what
+    // AnimatableProperty::getValueAt() returns for them.
+    auto index = std::max(frame - bakedStartTime, static_cast<Frame>(0));
+    return values[std::min(index, bakedFrames - 1)];
+  }
+
+  size_t bake(Frame maxFrames) override {
+    if (!std::is_trivially_copyable<T>::value) {
+      return 0;
+    }
+    if (bakedValues.load(std::memory_order_acquire) != nullptr) {
+      return static_cast<size_t>(bakedFrames) * sizeof(T);
+    }
+    auto startTime = this->keyframes.front()->startTime;
+    auto numFrames = this->keyframes.back()->endTime - startTime + 1;
+    if (numFrames <= 0 || numFrames > maxFrames) {
+      return 0;
+    }
+    auto values = new T[numFrames];
+    for (Frame i = 0; i < numFrames; i++) {
+      values[i] = AnimatableProperty<T>::getValueAt(startTime + i);
+    }
+    bakedStartTime = startTime;
+    bakedFrames = numFrames;
+    // Publish the table after its range, readers on other threads load them in reverse order.
+    bakedValues.store(values, std::memory_order_release);
+    return static_cast<size_t>(numFrames) * sizeof(T);
+  }
+
+ private:
+  std::unique_ptr<uint8_t[]> storage = nullptr;
+  std::atomic<T*> bakedValues = {nullptr};
+  Frame bakedStartTime = 0;
+  Frame bakedFrames = 0;
+};
+}  // namespace pag
@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PathKeyframe.h"
+
+namespace pag {
+void PathKeyframe::initialize() {
+  SingleEaseKeyframe<PathHandle>::initialize();
+  if (startValue == nullptr || endValue == nullptr || startValue->verbs.empty() ||
+      endValue->verbs.size() < startValue->verbs.size()) {
+    return;
+  }
+  interpolable = true;
+  if (startValue->verbs == endValue->verbs &&
+      startValue->points.size() == endValue->points.size()) {
+    alignedStart = startValue;
+    alignedEnd = endValue;
+    return;
+  }
+  // Interpolating at both ends produces the curve-normalized paths with identical verbs.
+  alignedStart = std::make_shared<PathData>();
+  alignedEnd = std::make_shared<PathData>();
+  startValue->interpolate(*endValue, alignedStart.get(), 0.0f);
+  startValue->interpolate(*endValue, alignedEnd.get(), 1.0f);
+}
+
+PathHandle PathKeyframe::getValueAt(Frame time) {
+  if (!interpolable) {
+    return SingleEaseKeyframe<PathHandle>::getValueAt(time);
+  }
+  auto progress = getProgress(time);
+  std::lock_guard<std::mutex> autoLock(locker);
+  // The previous result is still held by someone else, leave it untouched.
+  if (buffer == nullptr || buffer.use_count() > 1) {
+    buffer = std::make_shared<PathData>();
+    buffer->verbs = alignedStart->verbs;
+    buffer->points.resize(alignedStart->points.size());
+  }
+  // Lerp the points as a flat float array, which the compiler is able to vectorize.
+  auto count = alignedStart->points.size() * 2;
+  auto start = reinterpret_cast<const float*>(alignedStart->points.data());
+  auto end = reinterpret_cast<const float*>(alignedEnd->points.data());
+  auto result = reinterpret_cast<float*>(buffer->points.data());
+  for (size_t i = 0; i < count; i++) {
+    result[i] = start[i] + (end[i] - start[i]) * progress;
+  }
+  return buffer;
+}
+}  // namespace pag
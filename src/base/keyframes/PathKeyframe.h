@@ -0,0 +1,46 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <mutex>
+#include "SingleEaseKeyframe.h"
+
+namespace pag {
+/**
+ * PathKeyframe aligns the verbs of the start and end values once when initialized, so that sampling
+ * a frame only needs a flat lerp over two point arrays of the same length. The aligned copies are
+ * kept by the keyframe, while the decoded values stay unchanged since the File may be shared by
+ * other PAGFiles or encoded again. The result is written into a PathData owned by the keyframe,
+ * which is reused by the next sample if the caller has released it.
+ */
+class PathKeyframe : public SingleEaseKeyframe<PathHandle> {
+ public:
+  void initialize() override;
+  PathHandle getValueAt(Frame time) override;
+
+ private:
+  bool interpolable = false;
+  // The same handles as startValue and endValue if their verbs already match.
+  PathHandle alignedStart = nullptr;
+  PathHandle alignedEnd = nullptr;
+  // The keyframes are shared by the players of the same file on different threads.
+  std::mutex locker = {};
+  PathHandle buffer = nullptr;
+};
+}  // namespace pag
@@ -17,15 +17,20 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "pag/c/pag_decoder.h"
+#include "base/utils/TGFXCast.h"
+#include "rendering/layers/ContentVersion.h"
 #include "pag_types_priv.h"
 
+// The maximum number of released frame buffers kept by a decoder for later borrowing.
+static constexpr size_t MaxIdleFrameBuffers = 2;
+
 pag_decoder* pag_decoder_create(pag_composition* composition, float maxFrameRate, float scale) {
   if (composition == nullptr) {
     return nullptr;
   }
   if (auto pagComposition = ToPAGComposition(composition)) {
     if (auto decoder = pag::PAGDecoder::MakeFrom(pagComposition, maxFrameRate, scale)) {
-      return new pag_decoder(std::move(decoder));
+      return new pag_decoder(std::move(decoder), pagComposition);
     }
   }
   return nullptr;
@@ -91,3 +96,118 @@ bool pag_decoder_read_frame_to_hardware_buffer(pag_decoder* decoder, int index,
   }
   return decoder->p->readFrame(index, static_cast<pag::HardwareBufferRef>(buffer));
 }
+
+int pag_decoder_read_frames(pag_decoder* decoder, int startIndex, int frameCount, int frameStride,
+                            void* pixels, size_t rowBytes, size_t frameBytes,
+                            pag_color_type colorType, pag_alpha_type alphaType) {
+  if (decoder == nullptr) {
+    return 0;
+  }
+  pag::ColorType color;
+  if (!FromCColorType(colorType, &color)) {
+    return 0;
+  }
+  pag::AlphaType alpha;
+  if (!FromCAlphaType(alphaType, &alpha)) {
+    return 0;
+  }
+  return decoder->p->readFrames(startIndex, frameCount, frameStride, pixels, rowBytes, frameBytes,
+                                color, alpha);
+}
+
+const void* pag_decoder_acquire_frame(pag_decoder* decoder, int index, pag_color_type colorType,
+                                      pag_alpha_type alphaType, size_t* rowBytes) {
+  if (decoder == nullptr || rowBytes == nullptr) {
+    return nullptr;
+  }
+  pag::ColorType color;
+  if (!FromCColorType(colorType, &color)) {
+    return nullptr;
+  }
+  pag::AlphaType alpha;
+  if (!FromCAlphaType(alphaType, &alpha)) {
+    return nullptr;
+  }
+  auto info = tgfx::ImageInfo::Make(decoder->p->width(), decoder->p->height(), pag::ToTGFX(color),
+                                    pag::ToTGFX(alpha));
+  if (info.isEmpty()) {
+    return nullptr;
+  }
+  // The version is taken before reading, an edit made during the reading only causes the buffer to
+  // be read again by the next call.
+  auto composition = decoder->composition.lock();
+  auto contentVersion = composition ? pag::ContentVersion::Get(composition) : 0;
+  std::lock_guard<std::mutex> autoLock(decoder->frameLocker);
+  auto& frameBuffers = decoder->frameBuffers;
+  for (auto& frameBuffer : frameBuffers) {
+    if (frameBuffer.frameIndex == index && frameBuffer.colorType == color &&
+        frameBuffer.alphaType == alpha && frameBuffer.contentVersion == contentVersion) {
+      frameBuffer.refCount++;
+      *rowBytes = info.rowBytes();
+      return frameBuffer.pixels.get();
+    }
+  }
+  // The idle buffers holding outdated content can never be borrowed again.
+  auto iter = frameBuffers.begin();
+  while (iter != frameBuffers.end()) {
+    if (iter->refCount == 0 && iter->contentVersion != contentVersion) {
+      iter = frameBuffers.erase(iter);
+    } else {
+      iter++;
+    }
+  }
+  pag::PAGDecoderFrameBuffer* target = nullptr;
+  for (auto& frameBuffer : frameBuffers) {
+    if (frameBuffer.refCount == 0) {
+      target = &frameBuffer;
+      break;
+    }
+  }
+  if (target == nullptr) {
+    frameBuffers.emplace_back();
+    target = &frameBuffers.back();
+  }
+  if (target->byteSize != info.byteSize()) {
+    target->pixels.reset(new (std::nothrow) uint8_t[info.byteSize()]);
+    target->byteSize = target->pixels ? info.byteSize() : 0;
+  }
+  // Invalidates the buffer before reading, its content is undefined if the reading fails.
+  target->frameIndex = -1;
+  if (target->pixels == nullptr ||
+      !decoder->p->readFrame(index, target->pixels.get(), info.rowBytes(), color, alpha)) {
+    return nullptr;
+  }
+  target->frameIndex = index;
+  target->colorType = color;
+  target->alphaType = alpha;
+  target->contentVersion = contentVersion;
+  target->refCount = 1;
+  *rowBytes = info.rowBytes();
+  return target->pixels.get();
+}
+
+void pag_decoder_release_frame(pag_decoder* decoder, const void* pixels) {
+  if (decoder == nullptr || pixels == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> autoLock(decoder->frameLocker);
+  auto& frameBuffers = decoder->frameBuffers;
+  size_t idleCount = 0;
+  for (auto& frameBuffer : frameBuffers) {
+    if (frameBuffer.pixels.get() == pixels && frameBuffer.refCount > 0) {
+      frameBuffer.refCount--;
+    }
+    if (frameBuffer.refCount == 0) {
+      idleCount++;
+    }
+  }
+  auto iter = frameBuffers.begin();
+  while (iter != frameBuffers.end() && idleCount > MaxIdleFrameBuffers) {
+    if (iter->refCount == 0 && iter->pixels.get() != pixels) {
+      iter = frameBuffers.erase(iter);
+      idleCount--;
+    } else {
+      iter++;
+    }
+  }
+}
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
 #include "pag/c/pag_types.h"
 #include "pag/pag.h"
 #include "rendering/PAGAnimator.h"
@@ -135,12 +137,30 @@ struct pag_backend_semaphore {
   pag::BackendSemaphore p;
 };
 
+namespace pag {
+struct PAGDecoderFrameBuffer {
+  std::unique_ptr<uint8_t[]> pixels = nullptr;
+  size_t byteSize = 0;
+  int frameIndex = -1;
+  ColorType colorType = ColorType::Unknown;
+  AlphaType alphaType = AlphaType::Unknown;
+  uint32_t contentVersion = 0;
+  int refCount = 0;
+};
+}  // namespace pag
+
 struct pag_decoder {
-  explicit pag_decoder(std::shared_ptr<pag::PAGDecoder> decoder) : p(std::move(decoder)) {
+  pag_decoder(std::shared_ptr<pag::PAGDecoder> decoder,
+              std::shared_ptr<pag::PAGComposition> composition)
+      : p(std::move(decoder)), composition(std::move(composition)) {
   }
 
   PAGObjectType type = PAGObjectType::Decoder;
   std::shared_ptr<pag::PAGDecoder> p;
+  // Used to detect edits of the composition that invalidate the borrowed frame buffers.
+  std::weak_ptr<pag::PAGComposition> composition;
+  std::mutex frameLocker = {};
+  std::vector<pag::PAGDecoderFrameBuffer> frameBuffers = {};
 };
 
 struct pag_animator {
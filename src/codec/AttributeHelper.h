@@ -123,22 +123,38 @@ T ReadValue(DecodeStream* stream, const AttributeConfig<T>& config, const Attrib
 
 template <typename T>
 std::vector<Keyframe<T>*> ReadKeyframes(DecodeStream* stream, const AttributeConfig<T>& config,
-                                        const AttributeFlag& flag) {
+                                        const AttributeFlag& flag,
+                                        std::unique_ptr<uint8_t[]>* storage) {
   std::vector<Keyframe<T>*> keyframes;
   auto numFrames = stream->readEncodedUint32();
+  // Every keyframe takes at least one byte to store its time.
+  if (numFrames > stream->bytesAvailable()) {
+    return keyframes;
+  }
+  std::vector<Enum> interpolationTypes(numFrames, KeyframeInterpolationType::Hold);
+  size_t storageSize = 0;
   for (uint32_t i = 0; i < numFrames; i++) {
+    // There is no need to read any bits for discrete properties.
+    if (config.attributeType != AttributeType::DiscreteProperty) {
+      interpolationTypes[i] = static_cast<Enum>(stream->readUBits(2));
+    }
+    auto keyframeSize = interpolationTypes[i] == KeyframeInterpolationType::Hold
+                            ? sizeof(Keyframe<T>)
+                            : config.keyframeSize(flag);
+    storageSize += PackedKeyframeSize(keyframeSize);
+  }
+  storage->reset(new uint8_t[storageSize]);
+  auto memory = storage->get();
+  keyframes.reserve(numFrames);
+  for (auto interpolationType : interpolationTypes) {
     Keyframe<T>* keyframe;
-    if (config.attributeType == AttributeType::DiscreteProperty) {
-      // There is no need to read any bits here.
-      keyframe = new Keyframe<T>();
+    if (interpolationType == KeyframeInterpolationType::Hold) {
+      keyframe = new (memory) Keyframe<T>();
+      memory += PackedKeyframeSize(sizeof(Keyframe<T>));
     } else {
-      auto interpolationType = static_cast<Enum>(stream->readUBits(2));
-      if (interpolationType == KeyframeInterpolationType::Hold) {
-        keyframe = new Keyframe<T>();
-      } else {
-        keyframe = config.newKeyframe(flag);
-        keyframe->interpolationType = interpolationType;
-      }
+      keyframe = config.newKeyframe(flag, memory);
+      keyframe->interpolationType = interpolationType;
+      memory += PackedKeyframeSize(config.keyframeSize(flag));
     }
     keyframes.push_back(keyframe);
   }
@@ -250,7 +266,8 @@ Property<T>* ReadProperty(DecodeStream* stream, const AttributeConfig<T>& config
   Property<T>* property = nullptr;
   if (flag.exist) {
     if (flag.animatable) {
-      auto keyframes = ReadKeyframes(stream, config, flag);
+      std::unique_ptr<uint8_t[]> storage = nullptr;
+      auto keyframes = ReadKeyframes(stream, config, flag, &storage);
       if (keyframes.empty()) {
         PAGThrowError(stream->context, "Wrong number of keyframes.");
         return property;
@@ -260,7 +277,7 @@ Property<T>* ReadProperty(DecodeStream* stream, const AttributeConfig<T>& config
       if (flag.hasSpatial) {
         ReadSpatialEase(stream, keyframes);
       }
-      property = new AnimatableProperty<T>(keyframes);
+      property = new PackedAnimatableProperty<T>(keyframes, std::move(storage));
     } else {
       property = new Property<T>();
       property->value = ReadValue(stream, config, flag);
@@ -38,8 +38,19 @@ class AttributeConfigBase : public AttributeBase {
     return 1;
   }
 
-  virtual Keyframe<T>* newKeyframe(const AttributeFlag&) const {
-    return new K<T>();
+  /**
+   * Returns the size of the keyframe created by newKeyframe().
+   */
+  virtual size_t keyframeSize(const AttributeFlag&) const {
+    return sizeof(K<T>);
+  }
+
+  /**
+   * Constructs a new keyframe in the specified memory, which must have at least keyframeSize()
+   * bytes.
+   */
+  virtual Keyframe<T>* newKeyframe(const AttributeFlag&, void* memory) const {
+    return new (memory) K<T>();
   }
 
   void readAttribute(DecodeStream* stream, const AttributeFlag& flag, void* target) const override {
@@ -267,16 +278,29 @@ class AttributeConfig<Point> : public AttributeConfigBase<Point> {
     }
   }
 
-  Keyframe<Point>* newKeyframe(const AttributeFlag& flag) const override {
+  size_t keyframeSize(const AttributeFlag& flag) const override {
+    switch (attributeType) {
+      case AttributeType::MultiDimensionProperty:
+        return sizeof(MultiDimensionPointKeyframe);
+      case AttributeType::SpatialProperty:
+        if (flag.hasSpatial) {
+          return sizeof(SpatialPointKeyframe);
+        }
+      default:
+        return sizeof(SingleEaseKeyframe<Point>);
+    }
+  }
+
+  Keyframe<Point>* newKeyframe(const AttributeFlag& flag, void* memory) const override {
     switch (attributeType) {
       case AttributeType::MultiDimensionProperty:
-        return new MultiDimensionPointKeyframe();
+        return new (memory) MultiDimensionPointKeyframe();
       case AttributeType::SpatialProperty:
         if (flag.hasSpatial) {
-          return new SpatialPointKeyframe();
+          return new (memory) SpatialPointKeyframe();
         }
       default:
-        return new SingleEaseKeyframe<Point>();
+        return new (memory) SingleEaseKeyframe<Point>();
     }
   }
 };
@@ -317,16 +341,29 @@ class AttributeConfig<Point3D> : public AttributeConfigBase<Point3D> {
     }
   }
 
-  Keyframe<Point3D>* newKeyframe(const AttributeFlag& flag) const override {
+  size_t keyframeSize(const AttributeFlag& flag) const override {
+    switch (attributeType) {
+      case AttributeType::MultiDimensionProperty:
+        return sizeof(MultiDimensionPoint3DKeyframe);
+      case AttributeType::SpatialProperty:
+        if (flag.hasSpatial) {
+          return sizeof(SpatialPoint3DKeyframe);
+        }
+      default:
+        return sizeof(SingleEaseKeyframe<Point3D>);
+    }
+  }
+
+  Keyframe<Point3D>* newKeyframe(const AttributeFlag& flag, void* memory) const override {
     switch (attributeType) {
       case AttributeType::MultiDimensionProperty:
-        return new MultiDimensionPoint3DKeyframe();
+        return new (memory) MultiDimensionPoint3DKeyframe();
       case AttributeType::SpatialProperty:
         if (flag.hasSpatial) {
-          return new SpatialPoint3DKeyframe();
+          return new (memory) SpatialPoint3DKeyframe();
         }
       default:
-        return new SingleEaseKeyframe<Point3D>();
+        return new (memory) SingleEaseKeyframe<Point3D>();
     }
   }
 };
@@ -382,6 +419,14 @@ class AttributeConfig<PathHandle> : public AttributeConfigBase<PathHandle, Singl
  public:
   using AttributeConfigBase::AttributeConfigBase;
 
+  size_t keyframeSize(const AttributeFlag&) const override {
+    return sizeof(PathKeyframe);
+  }
+
+  Keyframe<PathHandle>* newKeyframe(const AttributeFlag&, void* memory) const override {
+    return new (memory) PathKeyframe();
+  }
+
   PathHandle readValue(DecodeStream* stream) const override {
     return ReadPath(stream);
   }
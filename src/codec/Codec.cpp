@@ -19,6 +19,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include "CompressionAlgorithm.h"
+#include "base/utils/BytesHash.h"
 #include "base/utils/USE.h"
 #include "base/utils/Verify.h"
 #include "codec/Version.h"
@@ -230,6 +231,7 @@ std::shared_ptr<File> Codec::Decode(const void* bytes, uint32_t byteLength,
     return nullptr;
   }
 
+  file->contentHash = HashBytes(bytes, byteLength);
   UpdateFileAttributes(file, &context, filePath);
   return file;
 }
@@ -20,6 +20,53 @@
 #include <cstring>
 
 namespace pag {
+/**
+ * BitUnpacker extracts fixed-width fields from a bit stream that has already been checked to hold
+ * all the fields, so it loads up to 64 bits at a time without any bounds checks per field.
+ */
+class BitUnpacker {
+ public:
+  BitUnpacker(const uint8_t* bytes, size_t length, size_t bitPosition, uint8_t numBits)
+      : bytes(bytes), length(length), bitPosition(bitPosition), numBits(numBits),
+        mask((static_cast<uint64_t>(1) << numBits) - 1) {
+  }
+
+  uint32_t readUBits() {
+    auto bytePosition = bitPosition >> 3;
+    uint64_t word = 0;
+    if (bytePosition + sizeof(uint64_t) <= length) {
+      memcpy(&word, bytes + bytePosition, sizeof(uint64_t));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+      word = __builtin_bswap64(word);
+#endif
+    } else {
+      // Near the end of the data, assembles the remaining bytes one by one.
+      for (size_t i = bytePosition; i < length; i++) {
+        word |= static_cast<uint64_t>(bytes[i]) << ((i - bytePosition) * 8);
+      }
+    }
+    auto value = static_cast<uint32_t>((word >> (bitPosition & 7)) & mask);
+    bitPosition += numBits;
+    return value;
+  }
+
+  int32_t readBits() {
+    auto value = readUBits() << (32 - numBits);
+    return static_cast<int32_t>(value) >> (32 - numBits);
+  }
+
+  size_t position() const {
+    return bitPosition;
+  }
+
+ private:
+  const uint8_t* bytes = nullptr;
+  size_t length = 0;
+  size_t bitPosition = 0;
+  uint8_t numBits = 0;
+  uint64_t mask = 0;
+};
+
 void DecodeStream::setPosition(uint32_t value) {
   if (!checkEndOfFile(value)) {
     positionChanged(static_cast<size_t>(value) - _position);
@@ -253,39 +300,87 @@ uint32_t DecodeStream::readUBits(uint8_t numBits) {
 
 void DecodeStream::readInt32List(int32_t* values, uint32_t count) {
   auto numBits = readNumBits();
+  if (!hasBits(static_cast<uint64_t>(count) * numBits)) {
+    for (uint32_t i = 0; i < count; i++) {
+      values[i] = readBits(numBits);
+    }
+    return;
+  }
+  BitUnpacker unpacker(dataView.bytes(), dataView.size(), _bitPosition, numBits);
   for (uint32_t i = 0; i < count; i++) {
-    values[i] = readBits(numBits);
+    values[i] = unpacker.readBits();
   }
+  bitPositionChanged(unpacker.position() - _bitPosition);
 }
 
 void DecodeStream::readUint32List(uint32_t* values, uint32_t count) {
   auto numBits = readNumBits();
+  if (!hasBits(static_cast<uint64_t>(count) * numBits)) {
+    for (uint32_t i = 0; i < count; i++) {
+      values[i] = readUBits(numBits);
+    }
+    return;
+  }
+  BitUnpacker unpacker(dataView.bytes(), dataView.size(), _bitPosition, numBits);
   for (uint32_t i = 0; i < count; i++) {
-    values[i] = readUBits(numBits);
+    values[i] = unpacker.readUBits();
   }
+  bitPositionChanged(unpacker.position() - _bitPosition);
 }
 
 void DecodeStream::readFloatList(float* values, uint32_t count, float precision) {
   auto numBits = readNumBits();
+  if (!hasBits(static_cast<uint64_t>(count) * numBits)) {
+    for (uint32_t i = 0; i < count; i++) {
+      values[i] = readBits(numBits) * precision;
+    }
+    return;
+  }
+  BitUnpacker unpacker(dataView.bytes(), dataView.size(), _bitPosition, numBits);
   for (uint32_t i = 0; i < count; i++) {
-    values[i] = readBits(numBits) * precision;
+    values[i] = unpacker.readBits() * precision;
   }
+  bitPositionChanged(unpacker.position() - _bitPosition);
 }
+
 void DecodeStream::readPoint2DList(Point* points, uint32_t count, float precision) {
   auto numBits = readNumBits();
+  if (!hasBits(static_cast<uint64_t>(count) * numBits * 2)) {
+    for (uint32_t i = 0; i < count; i++) {
+      points[i].x = readBits(numBits) * precision;
+      points[i].y = readBits(numBits) * precision;
+    }
+    return;
+  }
+  BitUnpacker unpacker(dataView.bytes(), dataView.size(), _bitPosition, numBits);
   for (uint32_t i = 0; i < count; i++) {
-    points[i].x = readBits(numBits) * precision;
-    points[i].y = readBits(numBits) * precision;
+    points[i].x = unpacker.readBits() * precision;
+    points[i].y = unpacker.readBits() * precision;
   }
+  bitPositionChanged(unpacker.position() - _bitPosition);
 }
 
 void DecodeStream::readPoint3DList(Point3D* points, uint32_t count, float precision) {
   auto numBits = readNumBits();
+  if (!hasBits(static_cast<uint64_t>(count) * numBits * 3)) {
+    for (uint32_t i = 0; i < count; i++) {
+      points[i].x = readBits(numBits) * precision;
+      points[i].y = readBits(numBits) * precision;
+      points[i].z = readBits(numBits) * precision;
+    }
+    return;
+  }
+  BitUnpacker unpacker(dataView.bytes(), dataView.size(), _bitPosition, numBits);
   for (uint32_t i = 0; i < count; i++) {
-    points[i].x = readBits(numBits) * precision;
-    points[i].y = readBits(numBits) * precision;
-    points[i].z = readBits(numBits) * precision;
+    points[i].x = unpacker.readBits() * precision;
+    points[i].y = unpacker.readBits() * precision;
+    points[i].z = unpacker.readBits() * precision;
   }
+  bitPositionChanged(unpacker.position() - _bitPosition);
+}
+
+bool DecodeStream::hasBits(uint64_t numBits) const {
+  return _bitPosition + numBits <= static_cast<uint64_t>(dataView.size()) * 8;
 }
 
 void DecodeStream::bitPositionChanged(size_t offset) {
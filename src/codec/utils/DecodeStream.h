@@ -241,6 +241,12 @@ class DecodeStream final {
 
   void positionChanged(size_t offset);
 
+  /**
+   * Returns true if the specified number of bits are available for reading from the current bit
+   * position. The list readers use it to check the bits of a whole list at once.
+   */
+  bool hasBits(uint64_t numBits) const;
+
   bool checkEndOfFile(uint32_t bytesToRead);
 };
 }  // namespace pag
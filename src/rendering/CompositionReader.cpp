@@ -33,11 +33,15 @@ std::shared_ptr<CompositionReader> CompositionReader::Make(int width, int height
 CompositionReader::CompositionReader(std::shared_ptr<BitmapDrawable> bitmapDrawable)
     : drawable(std::move(bitmapDrawable)) {
   pagPlayer = new PAGPlayer();
+  // The frames read by PAGDecoder are requested by the caller explicitly, refusing them only makes
+  // the reading fail. The player is neither admitted nor counted as an active player.
+  pagPlayer->memoryBudgetExempt = true;
   auto pagSurface = PAGSurface::MakeFrom(drawable);
   pagPlayer->setSurface(pagSurface);
 }
 
 CompositionReader::~CompositionReader() {
+  waitFrame();
   delete pagPlayer;
 }
 
@@ -57,6 +61,22 @@ bool CompositionReader::readFrame(double progress, std::shared_ptr<BitmapBuffer>
   return renderFrame(progress);
 }
 
+void CompositionReader::readFrameAsync(double progress, std::shared_ptr<BitmapBuffer> bitmap) {
+  waitFrame();
+  pendingTask = tgfx::Task::Run([this, progress, bitmap = std::move(bitmap)]() {
+    pendingResult = readFrame(progress, bitmap);
+  });
+}
+
+bool CompositionReader::waitFrame() {
+  if (pendingTask == nullptr) {
+    return false;
+  }
+  pendingTask->wait();
+  pendingTask = nullptr;
+  return pendingResult;
+}
+
 bool CompositionReader::renderFrame(double progress) {
   pagPlayer->setProgress(progress);
   pagPlayer->flush();
@@ -18,9 +18,11 @@
 
 #pragma once
 
+#include <atomic>
 #include "pag/pag.h"
 #include "rendering/drawables/BitmapDrawable.h"
 #include "rendering/utils/BitmapBuffer.h"
+#include "tgfx/utils/Task.h"
 
 namespace pag {
 class CompositionReader {
@@ -43,8 +45,23 @@ class CompositionReader {
 
   bool readFrame(double progress, std::shared_ptr<BitmapBuffer> bitmap);
 
+  /**
+   * Starts reading the frame at the specified progress into the bitmap on a background thread and
+   * returns immediately, which allows the caller to process the previous frame in the meantime. The
+   * bitmap must not be accessed until waitFrame() returns.
+   */
+  void readFrameAsync(double progress, std::shared_ptr<BitmapBuffer> bitmap);
+
+  /**
+   * Blocks until the frame started by the last readFrameAsync() call is read. Returns false if the
+   * reading failed or there is no pending frame.
+   */
+  bool waitFrame();
+
  private:
   std::mutex locker = {};
+  std::shared_ptr<tgfx::Task> pendingTask = nullptr;
+  std::atomic_bool pendingResult = false;
   PAGPlayer* pagPlayer = nullptr;
   std::shared_ptr<BitmapDrawable> drawable = nullptr;
 
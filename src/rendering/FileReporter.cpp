@@ -98,6 +98,15 @@ void FileReporter::reportData() {
   reportInfos.insert(std::make_pair("graphicsMemoryMax", std::to_string(graphicsMemoryMax)));
   reportInfos.insert(std::make_pair("graphicsMemoryAverage",
                                     std::to_string(GetAverage(graphicsMemoryTotal, flushCount))));
+  if (predictionCount > 0) {
+    reportInfos.insert(
+        std::make_pair("predictedGraphicsMemoryMax", std::to_string(predictedMemoryMax)));
+    reportInfos.insert(
+        std::make_pair("graphicsMemoryPredictionErrorMax", std::to_string(predictionErrorMax)));
+    reportInfos.insert(
+        std::make_pair("graphicsMemoryPredictionErrorAverage",
+                       std::to_string(GetAverage(predictionErrorTotal, predictionCount))));
+  }
   reportInfos.insert(std::make_pair("flushCount", std::to_string(flushCount)));
   reportInfos.insert(std::make_pair("pagInfo", pagInfoString));
   reportInfos.insert(std::make_pair("event", "pag_monitor"));
@@ -156,4 +165,12 @@ void FileReporter::recordPerformance(RenderCache* cache) {
       std::max(hardwareDecodingInitialTime, cache->hardwareDecodingInitialTime);
 }
 
+void FileReporter::recordPredictedMemory(int64_t predictedMemory, size_t actualMemory) {
+  auto error = predictedMemory - static_cast<int64_t>(actualMemory);
+  predictedMemoryMax = std::max(predictedMemoryMax, predictedMemory);
+  predictionErrorMax = std::max(predictionErrorMax, std::abs(error));
+  predictionErrorTotal += std::abs(error);
+  predictionCount++;
+}
+
 }  // namespace pag
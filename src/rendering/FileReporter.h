@@ -31,6 +31,7 @@ class FileReporter {
   explicit FileReporter(File* file);
   ~FileReporter();
   void recordPerformance(RenderCache* cache);
+  void recordPredictedMemory(int64_t predictedMemory, size_t actualMemory);
 
  private:
   void setFileInfo(File* file);
@@ -65,5 +66,10 @@ class FileReporter {
 
   size_t graphicsMemoryMax = 0;
   size_t graphicsMemoryTotal = 0;
+
+  int64_t predictedMemoryMax = 0;
+  int64_t predictionErrorMax = 0;
+  int64_t predictionErrorTotal = 0;
+  int predictionCount = 0;
 };
 }  // namespace pag
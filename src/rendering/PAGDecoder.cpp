@@ -72,8 +72,53 @@ std::pair<int, float> PAGDecoder::GetFrameCountAndRate(
   return {numFrames, frameRate};
 }
 
-std::vector<TimeRange> PAGDecoder::GetStaticTimeRange(std::shared_ptr<PAGComposition> composition,
-                                                      int numFrames) {
+std::string PAGDecoder::staticTimeRangesCacheKey(std::shared_ptr<PAGComposition> composition) {
+  std::string key = "";
+  if (cacheKeyGeneratorFun != nullptr) {
+    // An empty key returned by the generator disables the disk cache.
+    key = cacheKeyGeneratorFun(this, composition);
+  } else if (composition->isPAGFile() && pag::ContentVersion::Get(composition) == 0) {
+    // The static time ranges do not depend on the size of the decoder, so the default key leaves it
+    // out to share the analysis between the decoders of all sizes.
+    key = static_cast<PAGFile*>(composition.get())->path();
+    key = Platform::Current()->getSandboxPath(key);
+  }
+  if (key.empty()) {
+    return "";
+  }
+  // The decoders created by DiskSequenceReaders wrap the compositions in an empty container.
+  std::shared_ptr<PAGLayer> layer = composition;
+  while (layer->file == nullptr && layer->layerType() == LayerType::PreCompose &&
+         static_cast<PAGComposition*>(layer.get())->numChildren() == 1) {
+    layer = static_cast<PAGComposition*>(layer.get())->getLayerAt(0);
+  }
+  // The file may be replaced by another one at the same path, and the frames of a PAGFile are
+  // mapped differently if its time stretch mode is changed.
+  auto contentHash = layer->file != nullptr ? layer->file->contentHash : 0;
+  Enum timeStretchMode = PAGTimeStretchMode::None;
+  if (composition->isPAGFile()) {
+    timeStretchMode = static_cast<PAGFile*>(composition.get())->timeStretchMode();
+  }
+  return key + ".static." + std::to_string(contentHash) + "." + std::to_string(timeStretchMode) +
+         "." + std::to_string(_numFrames) + "." + std::to_string(composition->duration());
+}
+
+std::vector<TimeRange> PAGDecoder::getStaticTimeRanges(
+    std::shared_ptr<PAGComposition> composition) {
+  // Stepping through every frame is expensive, reuse the result of the previous analysis if the
+  // same file has been decoded before.
+  auto cacheKey = staticTimeRangesCacheKey(composition);
+  std::vector<TimeRange> timeRanges = {};
+  if (DiskCache::ReadStaticTimeRanges(cacheKey, _numFrames, &timeRanges)) {
+    return timeRanges;
+  }
+  timeRanges = AnalyzeStaticTimeRange(composition, _numFrames);
+  DiskCache::WriteStaticTimeRanges(cacheKey, _numFrames, timeRanges);
+  return timeRanges;
+}
+
+std::vector<TimeRange> PAGDecoder::AnalyzeStaticTimeRange(
+    std::shared_ptr<PAGComposition> composition, int numFrames) {
   LockGuard autoLock(composition->rootLocker);
   std::vector<TimeRange> timeRanges = {};
   auto startTime = composition->startTimeInternal();
@@ -119,8 +164,10 @@ PAGDecoder::PAGDecoder(std::shared_ptr<PAGComposition> composition, int width, i
       maxFrameRate(maxFrameRate) {
   container = PAGComposition::Make(width, height);
   container->addLayer(composition);
-  staticTimeRanges = GetStaticTimeRange(composition, _numFrames);
+  staticTimeRanges = getStaticTimeRanges(composition);
   lastImageInfo = new tgfx::ImageInfo();
+  LockGuard autoLock(composition->rootLocker);
+  recordLayerVersions(composition.get());
 }
 
 PAGDecoder::~PAGDecoder() {
@@ -167,7 +214,61 @@ bool PAGDecoder::readFrame(int index, HardwareBufferRef hardwareBuffer) {
   return readFrameInternal(index, bitmap);
 }
 
-bool PAGDecoder::readFrameInternal(int index, std::shared_ptr<BitmapBuffer> bitmap) {
+int PAGDecoder::readFrames(int startIndex, int frameCount, int frameStride, void* pixels,
+                           size_t rowBytes, size_t frameBytes, ColorType colorType,
+                           AlphaType alphaType) {
+  if (pixels == nullptr || frameCount <= 0 || frameStride <= 0 ||
+      frameBytes < rowBytes * static_cast<size_t>(_height)) {
+    LOGE("PAGDecoder::readFrames() Invalid arguments!");
+    return 0;
+  }
+  std::lock_guard<std::mutex> auoLock(locker);
+  auto info =
+      tgfx::ImageInfo::Make(_width, _height, ToTGFX(colorType), ToTGFX(alphaType), rowBytes);
+  if (info.isEmpty()) {
+    return 0;
+  }
+  auto dstPixels = static_cast<uint8_t*>(pixels);
+  const uint8_t* previousPixels = nullptr;
+  int previousIndex = -1;
+  std::shared_ptr<BitmapBuffer> nextBitmap = nullptr;
+  int count = 0;
+  for (; count < frameCount; count++) {
+    auto index = startIndex + count * frameStride;
+    auto framePixels = dstPixels + frameBytes * static_cast<size_t>(count);
+    // The composition may be edited between two frames, the previous output is outdated then.
+    auto contentVersion = lastContentVersion;
+    checkCompositionChange(getComposition());
+    if (contentVersion != lastContentVersion) {
+      previousPixels = nullptr;
+    }
+    if (previousPixels != nullptr && index >= 0 && index < _numFrames &&
+        GetTimeRangeContains(staticTimeRanges, index).contains(previousIndex)) {
+      memcpy(framePixels, previousPixels, info.byteSize());
+      lastReadIndex = index;
+      continue;
+    }
+    auto bitmap = nextBitmap != nullptr ? nextBitmap : BitmapBuffer::Wrap(info, framePixels);
+    // The next frame is rendered into its own output while the current one is being cached.
+    auto nextIndex = index + frameStride;
+    nextBitmap = nullptr;
+    if (count + 1 < frameCount && nextIndex >= 0 && nextIndex < _numFrames &&
+        !GetTimeRangeContains(staticTimeRanges, nextIndex).contains(index)) {
+      nextBitmap = BitmapBuffer::Wrap(info, framePixels + frameBytes);
+    }
+    if (!readFrameInternal(index, bitmap, nextIndex, nextBitmap)) {
+      break;
+    }
+    previousPixels = framePixels;
+    previousIndex = index;
+  }
+  // Makes sure the output is not written anymore after returning.
+  waitPendingFrame();
+  return count;
+}
+
+bool PAGDecoder::readFrameInternal(int index, std::shared_ptr<BitmapBuffer> bitmap, int nextIndex,
+                                   std::shared_ptr<BitmapBuffer> nextBitmap) {
   if (bitmap == nullptr) {
     LOGE("PAGDecoder::readFrame() The specified bitmap buffer is invalid!");
     return false;
@@ -181,17 +282,35 @@ bool PAGDecoder::readFrameInternal(int index, std::shared_ptr<BitmapBuffer> bitm
   if (!checkSequenceFile(composition, bitmap->info())) {
     return false;
   }
-  auto success = sequenceFile->readFrame(index, bitmap);
-  if (!success) {
-    success = renderFrame(composition, index, bitmap);
-    if (success) {
-      success = sequenceFile->writeFrame(index, bitmap);
-      if (!success) {
-        LOGE("PAGDecoder::readFrame() Failed to write frame to SequenceFile!");
-      }
+  auto success = false;
+  if (pendingIndex == index && pendingBitmap == bitmap) {
+    success = waitPendingFrame();
+  } else {
+    waitPendingFrame();
+    success = sequenceFile->readFrame(index, bitmap);
+    if (!success) {
+      success = readPreviousFrame(index, bitmap) || renderFrame(composition, index, bitmap);
+    } else {
+      // The frame is cached, there is nothing to write.
+      nextBitmap = nullptr;
+      bitmap = nullptr;
+    }
+  }
+  if (success && bitmap != nullptr) {
+    if (nextBitmap != nullptr && !sequenceFile->hasFrame(nextIndex) &&
+        !hasPreviousFrame(nextIndex)) {
+      renderFrameAsync(composition, nextIndex, nextBitmap);
     }
+    success = sequenceFile->writeFrame(index, bitmap);
+    if (!success) {
+      LOGE("PAGDecoder::readFrame() Failed to write frame to SequenceFile!");
+    }
+  }
+  if (sequenceFile->isComplete()) {
+    previousSequenceFile = nullptr;
+    changedTimeRanges = {};
   }
-  if (sequenceFile->isComplete() && composition != nullptr) {
+  if (sequenceFile->isComplete() && composition != nullptr && pendingIndex < 0) {
     if (reader != nullptr) {
       reader = nullptr;
       if (composition.use_count() != 1) {
@@ -228,6 +347,26 @@ bool PAGDecoder::renderFrame(std::shared_ptr<PAGComposition> composition, int in
   return reader->readFrame(progress, bitmap);
 }
 
+void PAGDecoder::renderFrameAsync(std::shared_ptr<PAGComposition> composition, int index,
+                                  std::shared_ptr<BitmapBuffer> bitmap) {
+  if (composition == nullptr || reader == nullptr) {
+    return;
+  }
+  auto progress = FrameToProgress(static_cast<Frame>(index), _numFrames);
+  reader->readFrameAsync(progress, bitmap);
+  pendingIndex = index;
+  pendingBitmap = std::move(bitmap);
+}
+
+bool PAGDecoder::waitPendingFrame() {
+  if (pendingIndex < 0) {
+    return false;
+  }
+  pendingIndex = -1;
+  pendingBitmap = nullptr;
+  return reader->waitFrame();
+}
+
 bool PAGDecoder::checkSequenceFile(std::shared_ptr<PAGComposition> composition,
                                    const tgfx::ImageInfo& info) {
   if (sequenceFile != nullptr) {
@@ -263,18 +402,162 @@ void PAGDecoder::checkCompositionChange(std::shared_ptr<PAGComposition> composit
   if (contentVersion == lastContentVersion) {
     return;
   }
-  sequenceFile = nullptr;
+  waitPendingFrame();
+  std::vector<TimeRange> timeRanges = {};
+  auto partialChanged = false;
+  {
+    LockGuard autoLock(composition->rootLocker);
+    if (sequenceFile != nullptr) {
+      partialChanged = collectChangedTimeRanges(composition.get(), composition.get(), &timeRanges);
+    }
+    layerVersions.clear();
+    recordLayerVersions(composition.get());
+  }
+  auto oldNumFrames = _numFrames;
+  auto oldFrameRate = _frameRate;
   lastContentVersion = contentVersion;
   lastReadIndex = -1;
   auto result = GetFrameCountAndRate(composition, maxFrameRate);
   _numFrames = result.first;
   _frameRate = result.second;
-  staticTimeRanges = GetStaticTimeRange(composition, _numFrames);
+  staticTimeRanges = getStaticTimeRanges(composition);
+  if (partialChanged && _numFrames == oldNumFrames && _frameRate == oldFrameRate) {
+    // The frames outside the changed time ranges are still valid, they are copied from the
+    // previous sequence file instead of being rendered again.
+    previousSequenceFile = sequenceFile;
+    changedTimeRanges = std::move(timeRanges);
+  } else {
+    previousSequenceFile = nullptr;
+    changedTimeRanges = {};
+  }
+  sequenceFile = nullptr;
+}
+
+// Collects the time ranges of the root affected by the changes inside the layer since the last
+// recordLayerVersions() call. Every modification increases the content versions of all ancestors of
+// the modified layer by one, so if the version increment of a composition equals the sum of its
+// children's, all changes happened inside the children. Returns false if the changed time ranges
+// can not be determined.
+bool PAGDecoder::collectChangedTimeRanges(PAGLayer* layer, PAGLayer* root,
+                                          std::vector<TimeRange>* timeRanges) const {
+  auto result = layerVersions.find(layer->uniqueID());
+  if (result == layerVersions.end()) {
+    return false;
+  }
+  if (layer->layerType() == LayerType::PreCompose) {
+    auto versionChange = layer->contentVersion - result->second;
+    uint32_t childrenChange = 0;
+    std::vector<PAGLayer*> changedLayers = {};
+    auto& layers = static_cast<PAGComposition*>(layer)->layers;
+    auto allFound = true;
+    for (auto& childLayer : layers) {
+      auto childResult = layerVersions.find(childLayer->uniqueID());
+      if (childResult == layerVersions.end()) {
+        allFound = false;
+        break;
+      }
+      auto childChange = childLayer->contentVersion - childResult->second;
+      if (childChange > 0) {
+        childrenChange += childChange;
+        changedLayers.push_back(childLayer.get());
+      }
+    }
+    if (allFound && childrenChange == versionChange) {
+      for (auto changedLayer : changedLayers) {
+        if (!collectChangedTimeRanges(changedLayer, root, timeRanges)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+  if (layer == root) {
+    return false;
+  }
+  TimeRange timeRange = {};
+  if (!getLayerTimeRange(layer, root, &timeRange)) {
+    return false;
+  }
+  if (timeRange.end >= 0 && timeRange.start < _numFrames) {
+    timeRanges->push_back(timeRange);
+  }
+  return true;
+}
+
+// Returns the frame indices of the root covering the visible range of the layer. The result is
+// expanded by one frame on both sides to be conservative about rounding.
+bool PAGDecoder::getLayerTimeRange(PAGLayer* layer, PAGLayer* root, TimeRange* timeRange) const {
+  if (root->stretchedFrameDuration() != root->frameDuration()) {
+    return false;
+  }
+  Frame startFrame = layer->startFrame;
+  Frame endFrame = layer->startFrame + layer->stretchedFrameDuration();
+  auto childFrameRate = layer->frameRateInternal();
+  auto parent = layer->getTimelineOwner();
+  while (parent != nullptr) {
+    // The time stretching of PAGFiles may map a frame to multiple ranges.
+    if (parent->stretchedFrameDuration() != parent->frameDuration()) {
+      return false;
+    }
+    startFrame = parent->childFrameToLocal(startFrame, childFrameRate);
+    endFrame = parent->childFrameToLocal(endFrame, childFrameRate);
+    if (parent == root) {
+      break;
+    }
+    childFrameRate = parent->frameRateInternal();
+    parent = parent->getTimelineOwner();
+  }
+  if (parent != root) {
+    return false;
+  }
+  auto duration = static_cast<double>(root->durationInternal());
+  if (duration <= 0) {
+    return false;
+  }
+  auto frameRate = root->frameRateInternal();
+  auto startTime = static_cast<double>(FrameToTime(startFrame - root->startFrame, frameRate));
+  auto endTime = static_cast<double>(FrameToTime(endFrame - root->startFrame, frameRate));
+  timeRange->start = static_cast<Frame>(floor(startTime * _numFrames / duration)) - 1;
+  timeRange->end = static_cast<Frame>(ceil(endTime * _numFrames / duration)) + 1;
+  return true;
+}
+
+void PAGDecoder::recordLayerVersions(PAGLayer* layer) {
+  layerVersions[layer->uniqueID()] = layer->contentVersion;
+  if (layer->layerType() == LayerType::PreCompose) {
+    for (auto& childLayer : static_cast<PAGComposition*>(layer)->layers) {
+      recordLayerVersions(childLayer.get());
+    }
+  }
+}
+
+bool PAGDecoder::hasPreviousFrame(int index) {
+  if (previousSequenceFile == nullptr) {
+    return false;
+  }
+  for (auto& timeRange : changedTimeRanges) {
+    if (timeRange.contains(index)) {
+      return false;
+    }
+  }
+  return previousSequenceFile->hasFrame(index);
+}
+
+bool PAGDecoder::readPreviousFrame(int index, std::shared_ptr<BitmapBuffer> bitmap) {
+  return hasPreviousFrame(index) && previousSequenceFile->info() == bitmap->info() &&
+         previousSequenceFile->readFrame(index, bitmap);
 }
 
 std::string PAGDecoder::generateCacheKey(std::shared_ptr<PAGComposition> composition) {
-  return cacheKeyGeneratorFun == nullptr ? DefaultCacheKeyGeneratorFunc(this, composition)
-                                         : cacheKeyGeneratorFun(this, composition);
+  if (cacheKeyGeneratorFun != nullptr) {
+    return cacheKeyGeneratorFun(this, composition);
+  }
+  auto key = DefaultCacheKeyGeneratorFunc(this, composition);
+  if (key.empty()) {
+    return key;
+  }
+  // The file may be replaced by another one at the same path.
+  return key + "." + std::to_string(composition->file->contentHash);
 }
 
 std::shared_ptr<PAGComposition> PAGDecoder::getComposition() {
@@ -290,6 +573,12 @@ std::shared_ptr<PAGComposition> PAGDecoder::getComposition() {
 void PAGDecoder::setCacheKeyGeneratorFun(
     std::function<std::string(PAGDecoder*, std::shared_ptr<PAGComposition> composition)> fun) {
   cacheKeyGeneratorFun = fun;
+  // The static time ranges have been analyzed in the constructor, cache them with the new key.
+  auto composition = getComposition();
+  if (composition != nullptr) {
+    DiskCache::WriteStaticTimeRanges(staticTimeRangesCacheKey(composition), _numFrames,
+                                     staticTimeRanges);
+  }
 }
 
 }  // namespace pag
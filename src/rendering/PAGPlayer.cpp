@@ -19,10 +19,13 @@
 #include "base/utils/TimeUtil.h"
 #include "pag/file.h"
 #include "rendering/FileReporter.h"
+#include "rendering/caches/MemoryBudgetManager.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/drawables/Drawable.h"
 #include "rendering/layers/PAGStage.h"
 #include "rendering/utils/ApplyScaleMode.h"
+#include "rendering/utils/FrameBudgetGovernor.h"
+#include "rendering/utils/FrameSnapshot.h"
 #include "rendering/utils/LockGuard.h"
 #include "rendering/utils/ScopedLock.h"
 #include "tgfx/utils/Clock.h"
@@ -32,13 +35,18 @@ PAGPlayer::PAGPlayer() {
   stage = PAGStage::Make(0, 0);
   rootLocker = stage->rootLocker;
   renderCache = new RenderCache(stage.get());
+  snapshotHolder = new FrameSnapshotHolder();
+  governor = new FrameBudgetGovernor();
 }
 
 PAGPlayer::~PAGPlayer() {
+  releaseMemoryBudget();
   delete renderCache;
   setSurface(nullptr);
   stage->removeAllLayers();
   delete reporter;
+  delete snapshotHolder;
+  delete governor;
 }
 
 std::shared_ptr<PAGComposition> PAGPlayer::getComposition() {
@@ -60,6 +68,10 @@ void PAGPlayer::setComposition(std::shared_ptr<PAGComposition> newComposition) {
     delete reporter;
     reporter = nullptr;
   }
+  releaseMemoryBudget();
+  memoryPredictions = {};
+  predictedPeakMemory = 0;
+  memoryPredicted = false;
   pagComposition = newComposition;
   if (pagComposition) {
     stage->doAddLayer(pagComposition, 0);
@@ -99,6 +111,7 @@ void PAGPlayer::setSurfaceInternal(std::shared_ptr<PAGSurface> newSurface) {
     updateStageSize();
   } else {
     stage->setContentSizeInternal(0, 0);
+    releaseMemoryBudget();
   }
 }
 
@@ -132,6 +145,26 @@ void PAGPlayer::setUseDiskCache(bool value) {
   renderCache->setUseDiskCache(value);
 }
 
+int PAGPlayer::videoDecodeAheadFrames() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->videoDecodeAheadFrames();
+}
+
+void PAGPlayer::setVideoDecodeAheadFrames(int value) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setVideoDecodeAheadFrames(value);
+}
+
+bool PAGPlayer::parallelRecordingEnabled() {
+  LockGuard autoLock(rootLocker);
+  return stage->parallelRecording();
+}
+
+void PAGPlayer::setParallelRecordingEnabled(bool value) {
+  LockGuard autoLock(rootLocker);
+  stage->setParallelRecording(value);
+}
+
 float PAGPlayer::cacheScale() {
   LockGuard autoLock(rootLocker);
   return stage->cacheScale();
@@ -143,7 +176,10 @@ void PAGPlayer::setCacheScale(float value) {
 }
 
 float PAGPlayer::maxFrameRate() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->maxFrameRate;
+  }
   return _maxFrameRate;
 }
 
@@ -155,8 +191,41 @@ void PAGPlayer::setMaxFrameRate(float value) {
   _maxFrameRate = value;
 }
 
-int PAGPlayer::scaleMode() {
+int64_t PAGPlayer::frameBudget() {
+  LockGuard autoLock(rootLocker);
+  return governor->frameBudget();
+}
+
+void PAGPlayer::setFrameBudget(int64_t budget) {
+  LockGuard autoLock(rootLocker);
+  auto oldLevel = governor->qualityLevel();
+  governor->setFrameBudget(budget);
+  applyQualityLevel();
+  if (governor->qualityLevel() != oldLevel && qualityLevelCallback) {
+    qualityLevelCallback(governor->qualityLevel());
+  }
+}
+
+int PAGPlayer::qualityLevel() {
   LockGuard autoLock(rootLocker);
+  return governor->qualityLevel();
+}
+
+void PAGPlayer::setQualityLevelCallback(std::function<void(int)> callback) {
+  LockGuard autoLock(rootLocker);
+  qualityLevelCallback = std::move(callback);
+}
+
+void PAGPlayer::applyQualityLevel() {
+  stage->setCacheScaleFactor(governor->cacheScaleFactor());
+  renderCache->setExpensiveFiltersEnabled(governor->expensiveFiltersEnabled());
+}
+
+int PAGPlayer::scaleMode() {
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->scaleMode;
+  }
   return _scaleMode;
 }
 
@@ -171,7 +240,10 @@ void PAGPlayer::setScaleMode(int mode) {
 }
 
 Matrix PAGPlayer::matrix() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->matrix;
+  }
   auto pagComposition = stage->getRootComposition();
   return pagComposition ? pagComposition->layerMatrix : Matrix::I();
 }
@@ -186,7 +258,10 @@ void PAGPlayer::setMatrix(const Matrix& matrix) {
 }
 
 int64_t PAGPlayer::duration() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->duration;
+  }
   return durationInternal();
 }
 
@@ -212,7 +287,10 @@ void PAGPlayer::preFrame() {
 }
 
 double PAGPlayer::getProgress() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->progress;
+  }
   auto pagComposition = stage->getRootComposition();
   return pagComposition ? pagComposition->getProgressInternal() : 0;
 }
@@ -225,10 +303,11 @@ void PAGPlayer::setProgress(double percent) {
   }
   auto realProgress = percent;
   auto frameRate = pagComposition->frameRateInternal();
-  if (_maxFrameRate < frameRate && _maxFrameRate > 0) {
+  auto maxFrameRate = std::min(_maxFrameRate, frameRate) * governor->frameRateFactor();
+  if (maxFrameRate < frameRate && maxFrameRate > 0) {
     auto duration = pagComposition->durationInternal();
     auto totalFrames = TimeToFrame(duration, frameRate);
-    auto numFrames = ceilf(totalFrames * _maxFrameRate / frameRate);
+    auto numFrames = ceilf(totalFrames * maxFrameRate / frameRate);
     // 首先计算在maxFrameRate的帧号，之后重新计算progress
     auto targetFrame = ProgressToFrame(realProgress, numFrames);
     realProgress = FrameToProgress(targetFrame, numFrames);
@@ -237,13 +316,19 @@ void PAGPlayer::setProgress(double percent) {
 }
 
 Frame PAGPlayer::currentFrame() const {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->currentFrame;
+  }
   auto pagComposition = stage->getRootComposition();
   return pagComposition ? pagComposition->currentFrameInternal() : 0;
 }
 
 bool PAGPlayer::autoClear() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->autoClear;
+  }
   return _autoClear;
 }
 
@@ -298,7 +383,33 @@ bool PAGPlayer::flushInternal(BackendSemaphore* signalSemaphore) {
   if (pagSurface == nullptr) {
     return false;
   }
+  if (!checkMemoryBudget()) {
+    return false;
+  }
   tgfx::Clock clock = {};
+  auto snapshot = std::make_shared<FrameSnapshot>();
+  // The performance data of the last frame is reset by prepareInternal(), so take it first.
+  snapshot->renderingTime =
+      renderCache->totalTime - renderCache->presentingTime - renderCache->imageDecodingTime;
+  snapshot->imageDecodingTime = renderCache->imageDecodingTime;
+  snapshot->presentingTime = renderCache->presentingTime;
+  snapshot->graphicsMemory = renderCache->memoryUsage();
+  // The stage size decides the matrix of the root composition, so it is updated before the
+  // snapshot is taken. Everything else is already settled for this frame.
+  updateStageSize();
+  auto pagComposition = stage->getRootComposition();
+  if (pagComposition) {
+    snapshot->duration = pagComposition->durationInternal();
+    snapshot->progress = pagComposition->getProgressInternal();
+    snapshot->currentFrame = pagComposition->currentFrameInternal();
+    snapshot->matrix = pagComposition->layerMatrix;
+  }
+  snapshot->scaleMode = _scaleMode;
+  snapshot->maxFrameRate = _maxFrameRate;
+  snapshot->autoClear = _autoClear;
+  // Queries from other threads read the snapshot instead of waiting for the recording and the
+  // drawing below.
+  RenderingScope renderingScope(snapshotHolder, std::move(snapshot));
   prepareInternal();
   clock.mark("rendering");
   if (!pagSurface->draw(renderCache, lastGraphic, signalSemaphore, _autoClear)) {
@@ -318,6 +429,17 @@ bool PAGPlayer::flushInternal(BackendSemaphore* signalSemaphore) {
   //  }
   if (reporter) {
     reporter->recordPerformance(renderCache);
+    if (memoryPredicted) {
+      reporter->recordPredictedMemory(predictedMemoryInternal(), renderCache->memoryUsage());
+    }
+  }
+  // The same as renderingTime() + presentingTime().
+  auto frameTime = renderCache->totalTime - renderCache->imageDecodingTime;
+  if (governor->recordFrame(frameTime)) {
+    applyQualityLevel();
+    if (qualityLevelCallback) {
+      qualityLevelCallback(governor->qualityLevel());
+    }
   }
   return true;
 }
@@ -388,27 +510,102 @@ int64_t PAGPlayer::getTimeStampInternal() {
 }
 
 int64_t PAGPlayer::renderingTime() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->renderingTime;
+  }
   // TODO(domrjchen): update the performance monitoring panel of PAGViewer to display the new
   // properties
   return renderCache->totalTime - renderCache->presentingTime - renderCache->imageDecodingTime;
 }
 
 int64_t PAGPlayer::imageDecodingTime() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->imageDecodingTime;
+  }
   return renderCache->imageDecodingTime;
 }
 
 int64_t PAGPlayer::presentingTime() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->presentingTime;
+  }
   return renderCache->presentingTime;
 }
 
 int64_t PAGPlayer::graphicsMemory() {
-  LockGuard autoLock(rootLocker);
+  SnapshotReadGuard readGuard(rootLocker, snapshotHolder);
+  if (auto snapshot = readGuard.snapshot()) {
+    return snapshot->graphicsMemory;
+  }
   return renderCache->memoryUsage();
 }
 
+int64_t PAGPlayer::predictedGraphicsMemory() {
+  LockGuard autoLock(rootLocker);
+  updateMemoryPrediction();
+  return predictedMemoryInternal();
+}
+
+void PAGPlayer::updateMemoryPrediction() {
+  if (memoryPredicted) {
+    return;
+  }
+  memoryPredicted = true;
+  auto pagComposition = stage->getRootComposition();
+  if (pagComposition == nullptr || !pagComposition->isPAGFile()) {
+    return;
+  }
+  memoryPredictions = CalculateGraphicsMemoriesPerFrame(pagComposition->getFile());
+  for (auto memory : memoryPredictions) {
+    predictedPeakMemory = std::max(predictedPeakMemory, memory);
+  }
+}
+
+int64_t PAGPlayer::predictedMemoryInternal() {
+  auto pagComposition = stage->getRootComposition();
+  if (pagComposition == nullptr || memoryPredictions.empty()) {
+    return 0;
+  }
+  auto numFrames = static_cast<Frame>(memoryPredictions.size());
+  auto frame = ProgressToFrame(pagComposition->getProgressInternal(), numFrames);
+  return memoryPredictions[static_cast<size_t>(frame)];
+}
+
+bool PAGPlayer::checkMemoryBudget() {
+  if (memoryBudgetExempt) {
+    return true;
+  }
+  auto manager = MemoryBudgetManager::GetInstance();
+  // Every flushing player is registered, so that it stays active when a budget is set later. The
+  // prediction is only calculated once there is a budget.
+  if (manager->budget() > 0) {
+    updateMemoryPrediction();
+  }
+  memoryAdmitted = manager->admit(this, predictedPeakMemory);
+  if (!memoryAdmitted) {
+    return false;
+  }
+  if (manager->takePurgeRequest(this)) {
+    renderCache->purgeCaches();
+  }
+  auto actualMemory = static_cast<int64_t>(renderCache->memoryUsage());
+  manager->update(this, actualMemory, predictedMemoryInternal());
+  return true;
+}
+
+void PAGPlayer::releaseMemoryBudget() {
+  MemoryBudgetManager::GetInstance()->release(this);
+  memoryAdmitted = true;
+}
+
+bool PAGPlayer::memoryBudgetAdmitted() {
+  LockGuard autoLock(rootLocker);
+  return memoryAdmitted;
+}
+
 bool PAGPlayer::updateStageSize() {
   if (pagSurface == nullptr) {
     return false;
@@ -68,6 +68,66 @@ bool DiskCache::WriteFile(const std::string& key, std::shared_ptr<tgfx::Data> da
   return GetInstance()->writeFile(key, data);
 }
 
+/**
+ * [version: uint8_t]
+ * [reserved: uint8_t * 3]
+ * [frameCount: uint32_t]
+ * [staticTimeRangeCount: uint32_t]
+ * [staticTimeRanges: [start: uint32_t, end: uint32_t] * staticTimeRangeCount]
+ */
+static constexpr uint8_t STATIC_TIME_RANGES_VERSION = 1;
+static constexpr size_t STATIC_TIME_RANGES_HEAD_SIZE = 12;
+
+bool DiskCache::ReadStaticTimeRanges(const std::string& key, int frameCount,
+                                     std::vector<TimeRange>* staticTimeRanges) {
+  auto cacheData = ReadFile(key);
+  if (cacheData == nullptr || cacheData->size() < STATIC_TIME_RANGES_HEAD_SIZE) {
+    return false;
+  }
+  auto data = tgfx::DataView(cacheData->bytes(), cacheData->size());
+  auto count = data.getUint32(8);
+  if (data.getUint8(0) != STATIC_TIME_RANGES_VERSION ||
+      data.getUint32(4) != static_cast<uint32_t>(frameCount) ||
+      cacheData->size() != STATIC_TIME_RANGES_HEAD_SIZE + static_cast<size_t>(count) * 8) {
+    return false;
+  }
+  std::vector<TimeRange> timeRanges = {};
+  timeRanges.reserve(count);
+  Frame lastEnd = -1;
+  for (uint32_t i = 0; i < count; i++) {
+    auto offset = STATIC_TIME_RANGES_HEAD_SIZE + static_cast<size_t>(i) * 8;
+    TimeRange timeRange = {data.getUint32(offset), data.getUint32(offset + 4)};
+    // The time ranges must be sorted and within the frame count, otherwise the cache is corrupted.
+    if (timeRange.start <= lastEnd || timeRange.end <= timeRange.start ||
+        timeRange.end >= frameCount) {
+      return false;
+    }
+    lastEnd = timeRange.end;
+    timeRanges.push_back(timeRange);
+  }
+  *staticTimeRanges = std::move(timeRanges);
+  return true;
+}
+
+bool DiskCache::WriteStaticTimeRanges(const std::string& key, int frameCount,
+                                      const std::vector<TimeRange>& staticTimeRanges) {
+  if (key.empty()) {
+    return false;
+  }
+  tgfx::Buffer buffer(STATIC_TIME_RANGES_HEAD_SIZE + staticTimeRanges.size() * 8);
+  buffer.clear();
+  auto data = tgfx::DataView(buffer.bytes(), buffer.size());
+  data.setUint8(0, STATIC_TIME_RANGES_VERSION);
+  data.setUint32(4, static_cast<uint32_t>(frameCount));
+  data.setUint32(8, static_cast<uint32_t>(staticTimeRanges.size()));
+  for (size_t i = 0; i < staticTimeRanges.size(); i++) {
+    auto offset = STATIC_TIME_RANGES_HEAD_SIZE + i * 8;
+    data.setUint32(offset, static_cast<uint32_t>(staticTimeRanges[i].start));
+    data.setUint32(offset + 4, static_cast<uint32_t>(staticTimeRanges[i].end));
+  }
+  return WriteFile(key, buffer.release());
+}
+
 DiskCache::DiskCache() {
   auto cacheDir = Platform::Current()->getCacheDir();
   if (!cacheDir.empty()) {
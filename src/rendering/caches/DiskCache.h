@@ -49,6 +49,21 @@ class DiskCache {
    */
   static bool WriteFile(const std::string& key, std::shared_ptr<tgfx::Data> data);
 
+  /**
+   * Reads the static time ranges of a composition with the specified frame count from the disk
+   * cache. Returns false if the key is empty, the cache does not exist, or it does not match the
+   * frame count.
+   */
+  static bool ReadStaticTimeRanges(const std::string& key, int frameCount,
+                                   std::vector<TimeRange>* staticTimeRanges);
+
+  /**
+   * Writes the static time ranges of a composition with the specified frame count to the disk
+   * cache. Returns false if the key is empty or the cache cannot be written.
+   */
+  static bool WriteStaticTimeRanges(const std::string& key, int frameCount,
+                                    const std::vector<TimeRange>& staticTimeRanges);
+
  private:
   std::mutex locker = {};
   std::string configPath;
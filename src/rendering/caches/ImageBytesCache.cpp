@@ -17,6 +17,9 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "ImageBytesCache.h"
+#include "rendering/caches/PreloadedImageCache.h"
+#include "rendering/graphics/ScaledImageGenerator.h"
+#include "tgfx/core/ImageCodec.h"
 
 namespace pag {
 
@@ -28,8 +31,8 @@ ImageBytesCache* ImageBytesCache::Get(ImageBytes* imageBytes) {
   auto cache = new ImageBytesCache();
   auto fileBytes =
       tgfx::Data::MakeWithCopy(imageBytes->fileBytes->data(), imageBytes->fileBytes->length());
-  auto image = tgfx::Image::MakeFromEncoded(std::move(fileBytes));
-  auto picture = Picture::MakeFrom(imageBytes->uniqueID, image);
+  auto image = tgfx::Image::MakeFromEncoded(fileBytes);
+  auto picture = Picture::MakeFrom(imageBytes->uniqueID, image, std::move(fileBytes));
   auto matrix = tgfx::Matrix::MakeScale(1 / imageBytes->scaleFactor);
   matrix.postTranslate(static_cast<float>(-imageBytes->anchorX),
                        static_cast<float>(-imageBytes->anchorY));
@@ -37,4 +40,37 @@ ImageBytesCache* ImageBytesCache::Get(ImageBytes* imageBytes) {
   imageBytes->cache = cache;
   return cache;
 }
+
+void ImageBytesCache::Preload(ImageBytes* imageBytes) {
+  if (imageBytes->fileBytes == nullptr || imageBytes->scaleFactor <= 0.0f) {
+    return;
+  }
+  auto imageCache = PreloadedImageCache::GetInstance();
+  if (imageCache->contains(imageBytes->uniqueID)) {
+    return;
+  }
+  auto fileBytes =
+      tgfx::Data::MakeWithCopy(imageBytes->fileBytes->data(), imageBytes->fileBytes->length());
+  auto codec = tgfx::ImageCodec::MakeFrom(std::move(fileBytes));
+  if (codec == nullptr || codec->isAlphaOnly()) {
+    return;
+  }
+  // The image is drawn at 1 / scaleFactor of its size when the file is displayed at its original
+  // size, which is the scale the RenderCache most likely decodes it at.
+  auto decodeScale = ScaledImageGenerator::GetDecodeScale(1.0f / imageBytes->scaleFactor);
+  std::shared_ptr<tgfx::ImageBuffer> buffer = nullptr;
+  if (decodeScale < 1.0f) {
+    auto generator = ScaledImageGenerator::Make(codec, decodeScale);
+    if (generator != nullptr) {
+      buffer = generator->makeBuffer();
+    }
+  } else {
+    buffer = codec->makeBuffer();
+  }
+  auto image = tgfx::Image::MakeFrom(std::move(buffer));
+  if (image == nullptr) {
+    return;
+  }
+  imageCache->add(imageBytes->uniqueID, decodeScale, image->makeOriented(codec->orientation()));
+}
 }  // namespace pag
\ No newline at end of file
@@ -25,6 +25,13 @@ namespace pag {
 class ImageBytesCache : public Cache {
  public:
   static ImageBytesCache* Get(ImageBytes* imageBytes);
+
+  /**
+   * Decodes the image of the specified ImageBytes on the calling thread at the scale it is most
+   * likely drawn at, and keeps it in the PreloadedImageCache until a render cache takes it over.
+   */
+  static void Preload(ImageBytes* imageBytes);
+
   std::shared_ptr<Graphic> graphic = nullptr;
 };
 }  // namespace pag
\ No newline at end of file
@@ -17,23 +17,100 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MaskCache.h"
+#include <algorithm>
 #include "rendering/graphics/FeatherMask.h"
 #include "rendering/renderers/MaskRenderer.h"
+#include "rendering/utils/PathUtil.h"
 
 namespace pag {
+static Frame GetStaticDuration(const std::vector<TimeRange>& timeRanges) {
+  Frame duration = 0;
+  for (auto& timeRange : timeRanges) {
+    duration += timeRange.duration();
+  }
+  return duration;
+}
+
 MaskCache::MaskCache(Layer* layer)
     : FrameCache<tgfx::Path>(layer->startTime, layer->duration), layer(layer) {
   std::vector<TimeRange> timeRanges = {layer->visibleRange()};
-  for (auto& mask : layer->masks) {
+  intersectOnly = true;
+  auto& masks = layer->masks;
+  for (size_t i = 0; i < masks.size(); i++) {
+    auto mask = masks[i];
     mask->excludeVaryingRanges(&timeRanges);
+    std::vector<TimeRange> maskTimeRanges = {layer->visibleRange()};
+    mask->excludeVaryingRanges(&maskTimeRanges);
+    maskStaticTimeRanges.push_back(OffsetTimeRanges(maskTimeRanges, -layer->startTime));
+    combineOrder.push_back(i);
+    if (i > 0 && mask->maskMode != MaskMode::None &&
+        ToPathOp(mask->maskMode) != tgfx::PathOp::Intersect) {
+      intersectOnly = false;
+    }
   }
   staticTimeRanges = OffsetTimeRanges(timeRanges, -layer->startTime);
+  if (intersectOnly) {
+    std::stable_sort(combineOrder.begin(), combineOrder.end(), [this](size_t a, size_t b) {
+      return GetStaticDuration(maskStaticTimeRanges[a]) >
+             GetStaticDuration(maskStaticTimeRanges[b]);
+    });
+  }
+  maskPaths.resize(masks.size());
+  combinedPaths.resize(masks.size());
 }
 
 tgfx::Path* MaskCache::createCache(Frame layerFrame) {
-  auto maskContent = new tgfx::Path();
-  RenderMasks(maskContent, layer->masks, layerFrame);
-  return maskContent;
+  auto& masks = layer->masks;
+  auto contentFrame = layerFrame - layer->startTime;
+  // Re-evaluate the masks whose static time ranges do not contain the frame.
+  std::vector<bool> changed(masks.size(), false);
+  auto firstMask = masks.size();
+  for (size_t i = 0; i < masks.size(); i++) {
+    auto key = ConvertFrameByStaticTimeRanges(maskStaticTimeRanges[i], contentFrame);
+    auto& maskPath = maskPaths[i];
+    if (maskPath.key != key) {
+      maskPath.key = key;
+      maskPath.applied = RenderMask(&maskPath.path, masks[i], layerFrame);
+      changed[i] = true;
+    }
+    if (maskPath.applied && firstMask == masks.size()) {
+      firstMask = i;
+    }
+  }
+  // The first applied mask is inverted if its mode is subtract, all combined paths are invalid if
+  // it changes.
+  size_t startIndex = 0;
+  if (firstMask == lastFirstMask) {
+    while (startIndex < combineOrder.size() && !changed[combineOrder[startIndex]]) {
+      startIndex++;
+    }
+  }
+  lastFirstMask = firstMask;
+  for (auto i = startIndex; i < combineOrder.size(); i++) {
+    auto index = combineOrder[i];
+    auto& combinedPath = combinedPaths[i];
+    combinedPath = i > 0 ? combinedPaths[i - 1] : CombinedPath();
+    auto& maskPath = maskPaths[index];
+    if (!maskPath.applied) {
+      continue;
+    }
+    auto path = maskPath.path;
+    auto mask = masks[index];
+    if (index == firstMask && mask->maskMode == MaskMode::Subtract) {
+      path.toggleInverseFillType();
+    }
+    if (!combinedPath.hasContent) {
+      combinedPath.hasContent = true;
+      combinedPath.path = path;
+    } else {
+      auto pathOp = intersectOnly ? tgfx::PathOp::Intersect : ToPathOp(mask->maskMode);
+      combinedPath.path.addPath(path, pathOp);
+    }
+  }
+  if (combinedPaths.empty()) {
+    return new tgfx::Path();
+  }
+  return new tgfx::Path(combinedPaths.back().path);
 }
 
 FeatherMaskCache::FeatherMaskCache(Layer* layer)
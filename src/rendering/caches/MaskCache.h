@@ -23,6 +23,11 @@
 #include "tgfx/core/Path.h"
 
 namespace pag {
+/**
+ * MaskCache combines the masks of a layer incrementally. Each mask is re-evaluated only when the
+ * frame leaves its own static time range, and the boolean combination restarts from the first
+ * changed mask, reusing the combined result of the unchanged masks before it.
+ */
 class MaskCache : public FrameCache<tgfx::Path> {
  public:
   explicit MaskCache(Layer* layer);
@@ -31,7 +36,28 @@ class MaskCache : public FrameCache<tgfx::Path> {
   tgfx::Path* createCache(Frame layerFrame) override;
 
  private:
+  struct MaskPath {
+    Frame key = -1;
+    bool applied = false;
+    tgfx::Path path = {};
+  };
+
+  struct CombinedPath {
+    bool hasContent = false;
+    tgfx::Path path = {};
+  };
+
   Layer* layer = nullptr;
+  // If all masks except the first are intersected, the combining order does not matter, and the
+  // masks are combined in order of their static durations, so the most static ones come first.
+  bool intersectOnly = false;
+  std::vector<size_t> combineOrder = {};
+  std::vector<std::vector<TimeRange>> maskStaticTimeRanges = {};
+  // The last evaluated path of each mask, in the original order.
+  std::vector<MaskPath> maskPaths = {};
+  // The results of combining the masks, in the combining order.
+  std::vector<CombinedPath> combinedPaths = {};
+  size_t lastFirstMask = 0;
 };
 
 class FeatherMaskCache : public FrameCache<GraphicContent> {
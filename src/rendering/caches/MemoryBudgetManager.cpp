@@ -0,0 +1,178 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryBudgetManager.h"
+#include <algorithm>
+#include <vector>
+#include "pag/pag.h"
+#include "rendering/caches/RenderCache.h"
+
+namespace pag {
+MemoryBudgetManager* MemoryBudgetManager::GetInstance() {
+  static auto& manager = *new MemoryBudgetManager();
+  return &manager;
+}
+
+int64_t MemoryBudgetManager::budget() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return _budget;
+}
+
+void MemoryBudgetManager::setBudget(int64_t value) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  _budget = value > 0 ? value : 0;
+}
+
+bool MemoryBudgetManager::admit(const void* owner, int64_t peakMemory) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return admitInternal(owner, peakMemory, false);
+}
+
+bool MemoryBudgetManager::reserve(const void* owner, int64_t memory) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return admitInternal(owner, memory, true);
+}
+
+void MemoryBudgetManager::release(const void* owner) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  entries.erase(owner);
+}
+
+void MemoryBudgetManager::update(const void* owner, int64_t actualMemory,
+                                 int64_t predictedMemory) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = entries.find(owner);
+  if (result == entries.end()) {
+    return;
+  }
+  auto& self = result->second;
+  self.actualMemory = actualMemory;
+  self.lastUpdate = ++updateCount;
+  self.lastActiveTime = std::chrono::steady_clock::now();
+  if (_budget <= 0) {
+    return;
+  }
+  int64_t totalMemory = std::max(actualMemory, predictedMemory);
+  std::vector<Entry*> candidates = {};
+  for (auto& item : entries) {
+    if (item.first != owner) {
+      totalMemory += item.second.actualMemory;
+      candidates.push_back(&item.second);
+    }
+  }
+  auto overflow = totalMemory - _budget;
+  if (overflow <= 0) {
+    return;
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Entry* a, const Entry* b) { return a->lastUpdate < b->lastUpdate; });
+  // The owner itself is the last resort, its caches of the previous frames may be stale.
+  candidates.push_back(&self);
+  for (auto entry : candidates) {
+    if (overflow <= 0) {
+      break;
+    }
+    if (entry->actualMemory <= 0 || entry->purgeRequested) {
+      continue;
+    }
+    entry->purgeRequested = true;
+    overflow -= entry->actualMemory;
+  }
+}
+
+bool MemoryBudgetManager::takePurgeRequest(const void* owner) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = entries.find(owner);
+  if (result == entries.end() || !result->second.purgeRequested) {
+    return false;
+  }
+  result->second.purgeRequested = false;
+  return true;
+}
+
+int64_t MemoryBudgetManager::predictedUsage() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  removeIdleEntries();
+  return predictedUsageInternal(nullptr);
+}
+
+size_t MemoryBudgetManager::activeCount() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  removeIdleEntries();
+  return entries.size();
+}
+
+bool MemoryBudgetManager::admitInternal(const void* owner, int64_t peakMemory, bool pinned) {
+  auto now = std::chrono::steady_clock::now();
+  auto result = entries.find(owner);
+  if (result != entries.end()) {
+    result->second.peakMemory = peakMemory;
+    result->second.lastActiveTime = now;
+    return true;
+  }
+  removeIdleEntries();
+  if (_budget > 0 && !entries.empty() && predictedUsageInternal(owner) + peakMemory > _budget) {
+    return false;
+  }
+  auto& entry = entries[owner];
+  entry.peakMemory = peakMemory;
+  entry.lastUpdate = ++updateCount;
+  entry.lastActiveTime = now;
+  entry.pinned = pinned;
+  return true;
+}
+
+void MemoryBudgetManager::removeIdleEntries() {
+  auto idleTime = std::chrono::steady_clock::now() - idleTimeout;
+  auto iter = entries.begin();
+  while (iter != entries.end()) {
+    if (!iter->second.pinned && iter->second.lastActiveTime < idleTime) {
+      iter = entries.erase(iter);
+    } else {
+      iter++;
+    }
+  }
+}
+
+int64_t MemoryBudgetManager::predictedUsageInternal(const void* excluded) const {
+  int64_t usage = 0;
+  for (auto& item : entries) {
+    if (item.first != excluded) {
+      usage += item.second.peakMemory;
+    }
+  }
+  return usage;
+}
+
+int64_t PAGMemoryBudget::Budget() {
+  return MemoryBudgetManager::GetInstance()->budget();
+}
+
+void PAGMemoryBudget::SetBudget(int64_t bytes) {
+  MemoryBudgetManager::GetInstance()->setBudget(bytes);
+  RenderCache::UpdateSharedCaches();
+}
+
+int64_t PAGMemoryBudget::PredictedUsage() {
+  return MemoryBudgetManager::GetInstance()->predictedUsage();
+}
+
+size_t PAGMemoryBudget::ActivePlayers() {
+  return MemoryBudgetManager::GetInstance()->activeCount();
+}
+}  // namespace pag
@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace pag {
+/**
+ * Keeps the graphics memory of all players in the process within a budget, based on the memory
+ * predicted by CalculateGraphicsMemoriesPerFrame(). The owners are identified by their addresses.
+ * All methods are thread-safe and never call back into the owners.
+ */
+class MemoryBudgetManager {
+ public:
+  static MemoryBudgetManager* GetInstance();
+
+  /**
+   * Returns the budget of graphics memory in bytes. 0 means unlimited.
+   */
+  int64_t budget();
+
+  /**
+   * Sets the budget of graphics memory in bytes. Values less than or equal to 0 mean unlimited.
+   * The owners already active are not affected.
+   */
+  void setBudget(int64_t value);
+
+  /**
+   * Requests the owner to be active with the predicted peak memory in bytes, which is called by a
+   * player before every frame. An active owner stays active and only has its peak updated. Owners
+   * that have not called it for a while are considered idle and lose their reservation. A new owner
+   * is refused if the sum of the predicted peaks of all active owners would exceed the budget,
+   * unless there is no other active owner. Returns true if the owner is active.
+   */
+  bool admit(const void* owner, int64_t peakMemory);
+
+  /**
+   * Reserves memory in bytes for a task that is not a player, such as a preload. The reservation
+   * never becomes idle and is kept until release() is called. Returns false if the memory does not
+   * fit in the budget beside the active owners.
+   */
+  bool reserve(const void* owner, int64_t memory);
+
+  /**
+   * Removes the owner from the active owners.
+   */
+  void release(const void* owner);
+
+  /**
+   * Reports the actual memory of an active owner and the memory predicted for its upcoming frame.
+   * If the total would exceed the budget, the least recently updated owners are asked to purge
+   * their caches until enough memory is freed.
+   */
+  void update(const void* owner, int64_t actualMemory, int64_t predictedMemory);
+
+  /**
+   * Returns true if the owner has been asked to purge its caches since the last call.
+   */
+  bool takePurgeRequest(const void* owner);
+
+  /**
+   * Returns the sum of the predicted peak memory of all active owners.
+   */
+  int64_t predictedUsage();
+
+  /**
+   * Returns the number of active owners.
+   */
+  size_t activeCount();
+
+ private:
+  struct Entry {
+    int64_t peakMemory = 0;
+    int64_t actualMemory = 0;
+    uint64_t lastUpdate = 0;
+    std::chrono::steady_clock::time_point lastActiveTime = {};
+    bool pinned = false;
+    bool purgeRequested = false;
+  };
+
+  std::mutex locker = {};
+  int64_t _budget = 0;
+  uint64_t updateCount = 0;
+  std::chrono::steady_clock::duration idleTimeout = std::chrono::seconds(2);
+  std::unordered_map<const void*, Entry> entries = {};
+
+  bool admitInternal(const void* owner, int64_t peakMemory, bool pinned);
+  void removeIdleEntries();
+  int64_t predictedUsageInternal(const void* excluded) const;
+};
+}  // namespace pag
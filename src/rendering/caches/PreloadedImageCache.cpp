@@ -0,0 +1,96 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PreloadedImageCache.h"
+#include <algorithm>
+#include <cmath>
+#include "tgfx/utils/Clock.h"
+
+namespace pag {
+static constexpr float DECODE_SCALE_PRECISION = 0.001f;
+
+PreloadedImageCache* PreloadedImageCache::GetInstance() {
+  static auto& imageCache = *new PreloadedImageCache();
+  return &imageCache;
+}
+
+void PreloadedImageCache::setMaxIdleTime(int64_t time) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  maxIdleTime = std::max(time, static_cast<int64_t>(0));
+}
+
+bool PreloadedImageCache::contains(ID assetID) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  for (auto& item : images) {
+    if (item.assetID == assetID) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void PreloadedImageCache::add(ID assetID, float decodeScale, std::shared_ptr<tgfx::Image> image) {
+  if (image == nullptr) {
+    return;
+  }
+  std::list<PreloadedImage> expiredImages = {};
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto currentTime = tgfx::Clock::Now();
+  purgeExpiredImages(currentTime, &expiredImages);
+  for (auto iter = images.begin(); iter != images.end(); iter++) {
+    if (iter->assetID == assetID) {
+      expiredImages.splice(expiredImages.end(), images, iter);
+      break;
+    }
+  }
+  images.push_front({assetID, decodeScale, std::move(image), currentTime});
+}
+
+std::shared_ptr<tgfx::Image> PreloadedImageCache::take(ID assetID, float decodeScale) {
+  std::list<PreloadedImage> expiredImages = {};
+  std::lock_guard<std::mutex> autoLock(locker);
+  for (auto iter = images.begin(); iter != images.end(); iter++) {
+    if (iter->assetID != assetID) {
+      continue;
+    }
+    // The image is freed if it was decoded at another scale, it would never be taken otherwise.
+    std::shared_ptr<tgfx::Image> image = nullptr;
+    if (fabsf(iter->decodeScale - decodeScale) < DECODE_SCALE_PRECISION) {
+      image = std::move(iter->image);
+    }
+    expiredImages.splice(expiredImages.end(), images, iter);
+    return image;
+  }
+  return nullptr;
+}
+
+void PreloadedImageCache::purgeExpiredImages() {
+  std::list<PreloadedImage> expiredImages = {};
+  std::lock_guard<std::mutex> autoLock(locker);
+  purgeExpiredImages(tgfx::Clock::Now(), &expiredImages);
+}
+
+void PreloadedImageCache::purgeExpiredImages(int64_t currentTime,
+                                             std::list<PreloadedImage>* expiredImages) {
+  // The images are sorted by preload time in descending order, and they are freed after the locker
+  // is released.
+  while (!images.empty() && currentTime - images.back().preloadTime > maxIdleTime) {
+    expiredImages->splice(expiredImages->end(), images, std::prev(images.end()));
+  }
+}
+}  // namespace pag
@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include "pag/types.h"
+#include "tgfx/core/Image.h"
+
+namespace pag {
+/**
+ * PreloadedImageCache keeps the images decoded by PAGFile::preload() until a RenderCache takes
+ * them over. An image is taken only once and only if it was decoded at the scale the RenderCache
+ * asks for, otherwise it is freed. The images that are not taken within a few seconds are freed as
+ * well, so the preloaded pixels never outlive the first frames they were decoded for.
+ */
+class PreloadedImageCache {
+ public:
+  static PreloadedImageCache* GetInstance();
+
+  /**
+   * Sets the time in microseconds a preloaded image is kept before it is freed. The default value
+   * is 5 seconds.
+   */
+  void setMaxIdleTime(int64_t time);
+
+  /**
+   * Returns true if there is an image preloaded for the specified asset.
+   */
+  bool contains(ID assetID);
+
+  /**
+   * Adds an image of the specified asset which was decoded at the decodeScale.
+   */
+  void add(ID assetID, float decodeScale, std::shared_ptr<tgfx::Image> image);
+
+  /**
+   * Removes the image preloaded for the specified asset and returns it if it was decoded at the
+   * decodeScale. Returns nullptr if there is no such image.
+   */
+  std::shared_ptr<tgfx::Image> take(ID assetID, float decodeScale);
+
+  /**
+   * Frees the images which have not been taken within the max idle time. It is called by the
+   * RenderCaches at the end of every frame.
+   */
+  void purgeExpiredImages();
+
+ private:
+  struct PreloadedImage {
+    ID assetID = 0;
+    float decodeScale = 1.0f;
+    std::shared_ptr<tgfx::Image> image = nullptr;
+    int64_t preloadTime = 0;
+  };
+
+  std::mutex locker = {};
+  int64_t maxIdleTime = 5000000;  // 5s
+  std::list<PreloadedImage> images = {};
+
+  PreloadedImageCache() = default;
+
+  void purgeExpiredImages(int64_t currentTime, std::list<PreloadedImage>* expiredImages);
+};
+}  // namespace pag
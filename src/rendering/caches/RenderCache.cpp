@@ -17,16 +17,20 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "RenderCache.h"
+#include <algorithm>
 #include <functional>
 #include "base/utils/TimeUtil.h"
 #include "base/utils/UniqueID.h"
 #include "rendering/caches/ImageContentCache.h"
 #include "rendering/caches/LayerCache.h"
+#include "rendering/caches/MemoryBudgetManager.h"
+#include "rendering/caches/PreloadedImageCache.h"
 #include "rendering/editing/ImageReplacement.h"
 #include "rendering/filters/utils/Filter3DFactory.h"
 #include "rendering/renderers/FilterRenderer.h"
 #include "rendering/sequences/SequenceImageProxy.h"
 #include "rendering/sequences/SequenceInfo.h"
+#include "rendering/video/VideoDecoderPool.h"
 #include "tgfx/utils/Clock.h"
 
 namespace pag {
@@ -37,6 +41,42 @@ static constexpr int PURGEABLE_EXPIRED_FRAME = 10;
 static constexpr float SCALE_FACTOR_PRECISION = 0.001f;
 static constexpr float MIPMAP_ENABLED_THRESHOLD = -1.0f;      // 临时关闭 mipmap
 static constexpr int64_t DECODING_VISIBLE_DISTANCE = 500000;  // 提前 500ms 开始解码。
+// Each shared CPU cache takes 1/8 of the purgeable graphics memory, and 1/32 of the budget at most.
+static constexpr int64_t SHARED_CACHE_MEMORY_RATIO = 8;
+static constexpr int64_t SHARED_CACHE_BUDGET_RATIO = 32;
+
+size_t RenderCache::SharedCacheMemoryLimit() {
+  auto memory = static_cast<int64_t>(PURGEABLE_GRAPHICS_MEMORY) / SHARED_CACHE_MEMORY_RATIO;
+  auto budget = MemoryBudgetManager::GetInstance()->budget();
+  if (budget > 0) {
+    memory = std::min(memory, budget / SHARED_CACHE_BUDGET_RATIO);
+  }
+  return static_cast<size_t>(memory);
+}
+
+static std::mutex& SharedCacheLocker() {
+  static auto& locker = *new std::mutex();
+  return locker;
+}
+
+static std::vector<std::function<void(size_t)>>& SharedCaches() {
+  static auto& caches = *new std::vector<std::function<void(size_t)>>();
+  return caches;
+}
+
+void RenderCache::AddSharedCache(std::function<void(size_t)> setMaxMemory) {
+  std::lock_guard<std::mutex> autoLock(SharedCacheLocker());
+  setMaxMemory(SharedCacheMemoryLimit());
+  SharedCaches().push_back(std::move(setMaxMemory));
+}
+
+void RenderCache::UpdateSharedCaches() {
+  std::lock_guard<std::mutex> autoLock(SharedCacheLocker());
+  auto maxMemory = SharedCacheMemoryLimit();
+  for (auto& setMaxMemory : SharedCaches()) {
+    setMaxMemory(maxMemory);
+  }
+}
 
 RenderCache::RenderCache(PAGStage* stage) : _uniqueID(UniqueID::Next()), stage(stage) {
 }
@@ -61,6 +101,15 @@ void RenderCache::setVideoEnabled(bool value) {
   clearAllSequenceCaches();
 }
 
+void RenderCache::setVideoDecodeAheadFrames(int value) {
+  value = std::max(value, 1);
+  if (_videoDecodeAheadFrames == value) {
+    return;
+  }
+  _videoDecodeAheadFrames = value;
+  clearAllSequenceCaches();
+}
+
 bool RenderCache::initFilter(Filter* filter) {
   tgfx::Clock clock = {};
   auto result = filter->initialize(getContext());
@@ -179,6 +228,7 @@ void RenderCache::attachToContext(tgfx::Context* current, bool forDrawing) {
   for (auto assetID : removedAssets) {
     removeSnapshot(assetID);
     assetImages.erase(assetID);
+    assetDecodeScales.erase(assetID);
     decodedAssetImages.erase(assetID);
     clearSequenceCache(assetID);
     clearFilterCache(assetID);
@@ -202,6 +252,11 @@ void RenderCache::releaseAll() {
   deviceID = 0;
 }
 
+void RenderCache::purgeCaches() {
+  clearAllSnapshots();
+  clearAllTextAtlas();
+}
+
 void RenderCache::detachFromContext() {
   if (!isDrawingFrame) {
     context = nullptr;
@@ -210,6 +265,8 @@ void RenderCache::detachFromContext() {
   prepareNextFrame();
   recordPerformance();
   clearExpiredSequences();
+  VideoDecoderPool::GetInstance()->purgeExpiredDecoders();
+  PreloadedImageCache::GetInstance()->purgeExpiredImages();
   clearExpiredDecodedImages();
   clearExpiredSnapshots();
   if (!timestamps.empty()) {
@@ -413,14 +470,22 @@ std::shared_ptr<tgfx::Image> RenderCache::getAssetImage(ID assetID, const ImageP
 
 std::shared_ptr<tgfx::Image> RenderCache::getAssetImageInternal(ID assetID,
                                                                 const ImageProxy* proxy) {
+  auto decodeScale = proxy->getDecodeScale(stage->getAssetMaxScale(assetID));
   auto image = assetImages[assetID];
   if (image != nullptr) {
-    return image;
+    // Keep the decoded image unless it is too small for the new scale, or at least four times
+    // larger than needed, which avoids decoding again when the scale switches back and forth.
+    auto currentScale = assetDecodeScales[assetID];
+    if (decodeScale <= currentScale + SCALE_FACTOR_PRECISION && decodeScale * 4 > currentScale) {
+      return image;
+    }
   }
-  image = proxy->makeImage(this);
+  decodedAssetImages.erase(assetID);
+  image = decodeScale < 1.0f ? proxy->makeScaledImage(this, decodeScale) : proxy->makeImage(this);
   if (image == nullptr) {
     return nullptr;
   }
+  assetDecodeScales[assetID] = decodeScale;
   auto scaleFactor = stage->getAssetMinScale(assetID);
   if (scaleFactor < MIPMAP_ENABLED_THRESHOLD) {
     image = image->makeMipmapped(true);
@@ -461,6 +526,15 @@ std::shared_ptr<tgfx::Image> RenderCache::getSequenceImage(std::shared_ptr<Seque
   return queue->getImage(targetFrame);
 }
 
+std::shared_ptr<AlphaMask> RenderCache::getSequenceAlphaMask(
+    std::shared_ptr<SequenceInfo> sequence, Frame targetFrame) {
+  auto queue = getSequenceImageQueue(sequence, targetFrame);
+  if (queue == nullptr) {
+    return nullptr;
+  }
+  return queue->getAlphaMask(context, targetFrame);
+}
+
 SequenceImageQueue* RenderCache::getSequenceImageQueue(std::shared_ptr<SequenceInfo> sequence,
                                                        Frame targetFrame) {
   if (sequence == nullptr) {
@@ -536,7 +610,8 @@ SequenceImageQueue* RenderCache::makeSequenceImageQueue(std::shared_ptr<Sequence
     return nullptr;
   }
   auto layer = stage->getLayerFromReferenceMap(sequence->uniqueID());
-  auto queue = SequenceImageQueue::MakeFrom(sequence, layer, _useDiskCache).release();
+  auto queue = SequenceImageQueue::MakeFrom(sequence, layer, _useDiskCache, _videoDecodeAheadFrames)
+                   .release();
   if (queue == nullptr) {
     return nullptr;
   }
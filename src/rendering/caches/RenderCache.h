@@ -37,12 +37,38 @@
 #include "rendering/layers/PAGStage.h"
 #include "rendering/sequences/SequenceImageQueue.h"
 #include "rendering/sequences/SequenceInfo.h"
+#include "rendering/utils/LRUCache.h"
 #include "rendering/utils/PathHasher.h"
 #include "tgfx/gpu/Device.h"
 
 namespace pag {
 class RenderCache : public Performance {
  public:
+  /**
+   * Returns the max memory in bytes of each CPU cache shared by the RenderCaches of all players,
+   * such as the PathMeasureCache. It is a part of the purgeable graphics memory of one RenderCache,
+   * and shrinks along with the graphics memory budget if a small one is set.
+   */
+  static size_t SharedCacheMemoryLimit();
+
+  /**
+   * Creates an LRUCache shared by the RenderCaches of all players. Its max memory is set to
+   * SharedCacheMemoryLimit() when created and again whenever the graphics memory budget changes.
+   * The cache is never destroyed.
+   */
+  template <typename Key, typename Value, typename Hasher = std::hash<Key>>
+  static LRUCache<Key, Value, Hasher>* MakeSharedCache() {
+    auto cache = new LRUCache<Key, Value, Hasher>(0);
+    AddSharedCache([cache](size_t maxMemory) { cache->setMaxMemory(maxMemory); });
+    return cache;
+  }
+
+  /**
+   * Sends the new SharedCacheMemoryLimit() to all shared caches, which is called after the graphics
+   * memory budget changes.
+   */
+  static void UpdateSharedCaches();
+
   explicit RenderCache(PAGStage* stage);
 
   ~RenderCache() override;
@@ -87,6 +113,21 @@ class RenderCache : public Performance {
    */
   void setSnapshotEnabled(bool value);
 
+  /**
+   * If set to false, expensive filters such as motion blur and large glows are skipped while
+   * drawing. The default value is true.
+   */
+  bool expensiveFiltersEnabled() const {
+    return _expensiveFiltersEnabled;
+  }
+
+  /**
+   * Set the value of expensiveFiltersEnabled property.
+   */
+  void setExpensiveFiltersEnabled(bool value) {
+    _expensiveFiltersEnabled = value;
+  }
+
   /**
    * Returns true if there is snapshot cache available for specified asset ID.
    */
@@ -110,6 +151,18 @@ class RenderCache : public Performance {
     _useDiskCache = value;
   }
 
+  /**
+   * Returns the maximum number of video frames decoded ahead of the current frame.
+   */
+  int videoDecodeAheadFrames() const {
+    return _videoDecodeAheadFrames;
+  }
+
+  /**
+   * Set the value of videoDecodeAheadFrames property.
+   */
+  void setVideoDecodeAheadFrames(int value);
+
   /**
    * Returns a snapshot cache of specified asset id. Returns null if there is no associated cache
    * available. This is a read-only query which is used usually during hit testing.
@@ -153,6 +206,13 @@ class RenderCache : public Performance {
   std::shared_ptr<tgfx::Image> getSequenceImage(std::shared_ptr<SequenceInfo> sequence,
                                                 Frame targetFrame);
 
+  /**
+   * Returns the AlphaMask of the specified sequence frame. The mask is built on the first call for
+   * a frame and kept by the sequence until a mask of another frame is requested.
+   */
+  std::shared_ptr<AlphaMask> getSequenceAlphaMask(std::shared_ptr<SequenceInfo> sequence,
+                                                  Frame targetFrame);
+
   LayerFilter* getFilterCache(LayerStyle* layerStyle);
 
   LayerFilter* getFilterCache(Effect* effect);
@@ -173,6 +233,11 @@ class RenderCache : public Performance {
 
   void releaseAll();
 
+  /**
+   * Releases the snapshots and text atlases, which are created again on demand.
+   */
+  void purgeCaches();
+
  private:
   ID _uniqueID = 0;
   PAGStage* stage = nullptr;
@@ -183,13 +248,16 @@ class RenderCache : public Performance {
   size_t graphicsMemory = 0;
   bool _videoEnabled = true;
   bool _snapshotEnabled = true;
+  bool _expensiveFiltersEnabled = true;
   bool _useDiskCache = false;
+  int _videoDecodeAheadFrames = 1;
   std::unordered_set<ID> usedAssets = {};
   std::unordered_map<ID, Snapshot*> snapshotCaches = {};
   std::list<Snapshot*> snapshotLRU = {};
   std::unordered_map<Snapshot*, std::list<Snapshot*>::iterator> snapshotPositions = {};
   std::unordered_map<ID, TextAtlas*> textAtlases = {};
   std::unordered_map<ID, std::shared_ptr<tgfx::Image>> assetImages = {};
+  std::unordered_map<ID, float> assetDecodeScales = {};
   std::unordered_map<ID, std::shared_ptr<tgfx::Image>> decodedAssetImages = {};
   std::unordered_map<ID, std::vector<SequenceImageQueue*>> sequenceCaches = {};
   std::unordered_map<ID, std::unordered_map<Frame, SequenceImageQueue*>> usedSequences = {};
@@ -197,6 +265,8 @@ class RenderCache : public Performance {
   MotionBlurFilter* motionBlurFilter = nullptr;
   Filter* transform3DFilter = nullptr;
 
+  static void AddSharedCache(std::function<void(size_t)> setMaxMemory);
+
   // decoded image caches:
   void clearExpiredDecodedImages();
 
@@ -233,5 +303,6 @@ class RenderCache : public Performance {
   void recordPerformance();
 
   friend class PAGPlayer;
+  friend class Snapshot;
 };
 }  // namespace pag
@@ -255,6 +255,14 @@ bool SequenceFile::readFrame(int index, std::shared_ptr<BitmapBuffer> bitmap) {
   return true;
 }
 
+bool SequenceFile::hasFrame(int index) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (index < 0 || index >= _numFrames) {
+    return false;
+  }
+  return frames[index].size > 0;
+}
+
 bool SequenceFile::writeFrame(int index, std::shared_ptr<BitmapBuffer> bitmap) {
   std::lock_guard<std::mutex> autoLock(locker);
   if (index < 0 || index >= _numFrames || bitmap == nullptr) {
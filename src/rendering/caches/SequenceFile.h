@@ -100,6 +100,11 @@ class SequenceFile {
    */
   bool isComplete();
 
+  /**
+   * Returns true if the image frame at the specified index is cached in the sequence.
+   */
+  bool hasFrame(int index);
+
   /**
    * Reads an image frame from the sequence into the specified pixel address. Returns false if the
    * specified index is empty or the bitmap info is different from ours.
@@ -27,14 +27,15 @@
 
 namespace pag {
 std::shared_ptr<PAGImage> PAGImage::FromPath(const std::string& filePath) {
-  auto image = tgfx::Image::MakeFromFile(filePath);
-  return StillImage::MakeFrom(std::move(image));
+  auto fileBytes = tgfx::Data::MakeFromFile(filePath);
+  auto image = tgfx::Image::MakeFromEncoded(fileBytes);
+  return StillImage::MakeFrom(std::move(image), std::move(fileBytes));
 }
 
 std::shared_ptr<PAGImage> PAGImage::FromBytes(const void* bytes, size_t length) {
   auto fileBytes = tgfx::Data::MakeWithCopy(bytes, length);
-  auto image = tgfx::Image::MakeFromEncoded(std::move(fileBytes));
-  return StillImage::MakeFrom(std::move(image));
+  auto image = tgfx::Image::MakeFromEncoded(fileBytes);
+  return StillImage::MakeFrom(std::move(image), std::move(fileBytes));
 }
 
 std::shared_ptr<PAGImage> PAGImage::FromPixels(const void* pixels, int width, int height,
@@ -47,12 +48,13 @@ std::shared_ptr<PAGImage> PAGImage::FromPixels(const void* pixels, int width, in
   return StillImage::MakeFrom(image);
 }
 
-std::shared_ptr<StillImage> StillImage::MakeFrom(std::shared_ptr<tgfx::Image> image) {
+std::shared_ptr<StillImage> StillImage::MakeFrom(std::shared_ptr<tgfx::Image> image,
+                                                 std::shared_ptr<tgfx::Data> encodedData) {
   if (image == nullptr) {
     return nullptr;
   }
   auto pagImage = std::shared_ptr<StillImage>(new StillImage(image->width(), image->height()));
-  auto picture = Picture::MakeFrom(pagImage->uniqueID(), image);
+  auto picture = Picture::MakeFrom(pagImage->uniqueID(), image, std::move(encodedData));
   if (!picture) {
     return nullptr;
   }
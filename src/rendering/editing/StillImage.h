@@ -26,7 +26,12 @@ namespace pag {
 
 class StillImage : public PAGImage {
  public:
-  static std::shared_ptr<StillImage> MakeFrom(std::shared_ptr<tgfx::Image> image);
+  /**
+   * Creates a StillImage with specified image. If the encodedData of the image is provided, the
+   * image may be decoded at a reduced size when it is never displayed at full resolution.
+   */
+  static std::shared_ptr<StillImage> MakeFrom(std::shared_ptr<tgfx::Image> image,
+                                              std::shared_ptr<tgfx::Data> encodedData = nullptr);
 
  protected:
   std::shared_ptr<Graphic> getGraphic(int64_t) const override {
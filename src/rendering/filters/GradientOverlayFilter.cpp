@@ -69,7 +69,8 @@ void GradientOverlayFilter::draw(tgfx::Context* context, const FilterSource* sou
   matrix.postRotate(360.f - angle, centerX, centerY);
   matrix.postTranslate(offset.x * 0.01f * width, offset.y * 0.01f * height);
 
-  auto gradient = GradientPaint(style, startPoint, endPoint, colors, matrix, reverse);
+  auto gradient = GradientPaint(style, startPoint, endPoint, colors, matrix, reverse,
+                                gradStyle->colors->animatable());
   auto shader = gradient.getShader();
 
   if (opacity != 255) {
@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AlphaMask.h"
+#include <cmath>
+#include "tgfx/gpu/Surface.h"
+
+namespace pag {
+// The maximum width or height of a mask. Masks of common images keep the full resolution, while
+// masks of larger images are downsampled to keep them under 128KB.
+static constexpr int MAX_MASK_SIZE = 1024;
+
+std::shared_ptr<AlphaMask> AlphaMask::Make(tgfx::Context* context,
+                                           std::shared_ptr<tgfx::Image> image) {
+  if (context == nullptr || image == nullptr) {
+    return nullptr;
+  }
+  auto imageWidth = static_cast<float>(image->width());
+  auto imageHeight = static_cast<float>(image->height());
+  auto maxSize = std::max(imageWidth, imageHeight);
+  auto scale = std::min(1.0f, static_cast<float>(MAX_MASK_SIZE) / maxSize);
+  auto width = std::max(1, static_cast<int>(ceilf(imageWidth * scale)));
+  auto height = std::max(1, static_cast<int>(ceilf(imageHeight * scale)));
+  auto surface = tgfx::Surface::Make(context, width, height);
+  if (surface == nullptr) {
+    return nullptr;
+  }
+  auto scaleX = static_cast<float>(width) / imageWidth;
+  auto scaleY = static_cast<float>(height) / imageHeight;
+  auto canvas = surface->getCanvas();
+  canvas->setMatrix(tgfx::Matrix::MakeScale(scaleX, scaleY));
+  canvas->drawImage(std::move(image));
+  auto info = tgfx::ImageInfo::Make(width, height, tgfx::ColorType::RGBA_8888,
+                                    tgfx::AlphaType::Premultiplied);
+  std::vector<uint8_t> pixels(info.byteSize());
+  if (!surface->readPixels(info, pixels.data())) {
+    return nullptr;
+  }
+  auto mask = std::shared_ptr<AlphaMask>(new AlphaMask(width, height, scaleX, scaleY));
+  auto count = static_cast<size_t>(width) * static_cast<size_t>(height);
+  for (size_t i = 0; i < count; i++) {
+    auto alpha = pixels[i * info.bytesPerPixel() + 3];
+    if (alpha > 0) {
+      mask->bits[i >> 3] |= static_cast<uint8_t>(1 << (i & 7));
+    }
+  }
+  return mask;
+}
+
+AlphaMask::AlphaMask(int width, int height, float scaleX, float scaleY)
+    : width(width), height(height), scaleX(scaleX), scaleY(scaleY),
+      bits((static_cast<size_t>(width) * static_cast<size_t>(height) + 7) / 8, 0) {
+}
+
+bool AlphaMask::hitTest(float x, float y) const {
+  auto maskX = static_cast<int>(floorf(x * scaleX));
+  auto maskY = static_cast<int>(floorf(y * scaleY));
+  if (maskX < 0 || maskX >= width || maskY < 0 || maskY >= height) {
+    return false;
+  }
+  auto index = static_cast<size_t>(maskY) * static_cast<size_t>(width) + maskX;
+  return (bits[index >> 3] & (1 << (index & 7))) != 0;
+}
+}  // namespace pag
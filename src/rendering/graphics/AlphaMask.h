@@ -0,0 +1,61 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include "tgfx/core/Image.h"
+#include "tgfx/gpu/Context.h"
+
+namespace pag {
+/**
+ * AlphaMask is a downsampled 1-bit representation of the alpha channel of an image. It reads the
+ * pixels back from the GPU only once when it is created, then answers hit tests on the CPU.
+ */
+class AlphaMask {
+ public:
+  /**
+   * Creates a new AlphaMask by drawing the image into a downsampled surface and reading back its
+   * alpha channel. Returns nullptr if the image is nullptr or the pixels fail to be read.
+   */
+  static std::shared_ptr<AlphaMask> Make(tgfx::Context* context,
+                                         std::shared_ptr<tgfx::Image> image);
+
+  /**
+   * Returns true if the pixel at the specified point is not fully transparent. The point is in the
+   * coordinate space of the original image.
+   */
+  bool hitTest(float x, float y) const;
+
+  /**
+   * Returns the number of bytes used by the bits of this AlphaMask.
+   */
+  size_t memoryUsage() const {
+    return bits.size();
+  }
+
+ private:
+  int width = 0;
+  int height = 0;
+  float scaleX = 1.0f;
+  float scaleY = 1.0f;
+  std::vector<uint8_t> bits = {};
+
+  AlphaMask(int width, int height, float scaleX, float scaleY);
+};
+}  // namespace pag
@@ -17,8 +17,10 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "GradientPaint.h"
+#include <string>
 #include "base/utils/Interpolate.h"
 #include "base/utils/TGFXCast.h"
+#include "rendering/caches/RenderCache.h"
 
 namespace pag {
 void ConvertColorStop(const GradientColorHandle& gradientColor, std::vector<Color>& colorValues,
@@ -55,11 +57,11 @@ void ConvertAlphaStop(const GradientColorHandle& gradientColor, std::vector<Opac
   }
 }
 
-GradientPaint::GradientPaint(Enum fillType, Point startPoint, Point endPoint,
-                             const GradientColorHandle& gradientColor, const tgfx::Matrix& matrix,
-                             bool reverse)
-    : gradientType(fillType), startPoint(ToTGFX(startPoint)), endPoint(ToTGFX(endPoint)),
-      matrix(matrix) {
+static std::shared_ptr<GradientRamp> MakeRamp(const GradientColorHandle& gradientColor,
+                                              bool reverse) {
+  auto ramp = std::make_shared<GradientRamp>();
+  auto& colors = ramp->colors;
+  auto& positions = ramp->positions;
   std::vector<Color> colorValues;
   std::vector<float> colorPositions;
   ConvertColorStop(gradientColor, colorValues, colorPositions);
@@ -120,15 +122,94 @@ GradientPaint::GradientPaint(Enum fillType, Point startPoint, Point endPoint,
     colors.push_back(color4f);
   }
   if (reverse) {
-    std::swap(startPoint, endPoint);
     std::reverse(colors.begin(), colors.end());
     std::reverse(positions.begin(), positions.end());
     std::transform(positions.begin(), positions.end(), positions.begin(),
                    [](float x) { return 1.f - x; });
   }
+  auto& reflectedColors = ramp->reflectedColors;
+  reflectedColors = colors;
+  reflectedColors.insert(reflectedColors.begin(), colors.rbegin(), colors.rend() - 1);
+  auto& reflectedPositions = ramp->reflectedPositions;
+  reflectedPositions = positions;
+  reflectedPositions.insert(reflectedPositions.begin(), positions.rbegin(), positions.rend() - 1);
+  auto size = static_cast<int>(positions.size());
+  std::transform(reflectedPositions.begin(), reflectedPositions.begin() + size,
+                 reflectedPositions.begin(),
+                 [](float position) { return (1.f - position) * 0.5; });
+  std::transform(reflectedPositions.begin() + size, reflectedPositions.end(),
+                 reflectedPositions.begin() + size,
+                 [](float position) { return position * 0.5f + 0.5f; });
+  return ramp;
+}
+
+/**
+ * GradientRampCache keeps the most recently baked ramps within a memory limit. Most templates
+ * animate the geometry of their gradients while the stops stay constant, so the same stops are
+ * converted only once.
+ */
+class GradientRampCache {
+ public:
+  static std::shared_ptr<const GradientRamp> Get(const GradientColorHandle& gradientColor,
+                                                 bool reverse) {
+    static auto& cache =
+        *RenderCache::MakeSharedCache<std::string, std::shared_ptr<const GradientRamp>>();
+    auto key = MakeKey(gradientColor, reverse);
+    std::shared_ptr<const GradientRamp> ramp = nullptr;
+    if (cache.find(key, &ramp)) {
+      return ramp;
+    }
+    ramp = MakeRamp(gradientColor, reverse);
+    auto stopCount = ramp->colors.size() + ramp->reflectedColors.size();
+    auto memory = key.size() + stopCount * (sizeof(tgfx::Color) + sizeof(float));
+    cache.add(key, ramp, memory);
+    return ramp;
+  }
+
+ private:
+  static std::string MakeKey(const GradientColorHandle& gradientColor, bool reverse) {
+    auto& colorStops = gradientColor->colorStops;
+    auto& alphaStops = gradientColor->alphaStops;
+    std::string key = {};
+    key.reserve(sizeof(uint32_t) * 2 + colorStops.size() * sizeof(ColorStop) +
+                alphaStops.size() * sizeof(AlphaStop) + 1);
+    auto append = [&](const void* data, size_t length) {
+      key.append(static_cast<const char*>(data), length);
+    };
+    auto colorCount = static_cast<uint32_t>(colorStops.size());
+    auto alphaCount = static_cast<uint32_t>(alphaStops.size());
+    append(&colorCount, sizeof(colorCount));
+    append(&alphaCount, sizeof(alphaCount));
+    for (auto& stop : colorStops) {
+      append(&stop.position, sizeof(float));
+      append(&stop.midpoint, sizeof(float));
+      append(&stop.color, sizeof(Color));
+    }
+    for (auto& stop : alphaStops) {
+      append(&stop.position, sizeof(float));
+      append(&stop.midpoint, sizeof(float));
+      append(&stop.opacity, sizeof(Opacity));
+    }
+    key.push_back(reverse ? 1 : 0);
+    return key;
+  }
+};
+
+GradientPaint::GradientPaint(Enum fillType, Point startPoint, Point endPoint,
+                             const GradientColorHandle& gradientColor, const tgfx::Matrix& matrix,
+                             bool reverse, bool animated)
+    : gradientType(fillType), startPoint(ToTGFX(startPoint)), endPoint(ToTGFX(endPoint)),
+      ramp(animated ? MakeRamp(gradientColor, reverse)
+                    : GradientRampCache::Get(gradientColor, reverse)),
+      matrix(matrix) {
 }
 
 std::shared_ptr<tgfx::Shader> GradientPaint::getShader() const {
+  if (ramp == nullptr) {
+    return nullptr;
+  }
+  auto& colors = ramp->colors;
+  auto& positions = ramp->positions;
   std::shared_ptr<tgfx::Shader> shader;
   if (gradientType == GradientFillType::Linear) {
     shader = tgfx::Shader::MakeLinearGradient(startPoint, endPoint, colors, positions);
@@ -140,19 +221,8 @@ std::shared_ptr<tgfx::Shader> GradientPaint::getShader() const {
     center.set(center.x * 0.5f, center.y * 0.5f);
     shader = tgfx::Shader::MakeSweepGradient(center, 0, 360, colors, positions);
   } else if (gradientType == GradientFillType::Reflected) {
-    auto reflectedColors = colors;
-    reflectedColors.insert(reflectedColors.begin(), colors.rbegin(), colors.rend() - 1);
-    auto reflectedPositions = positions;
-    reflectedPositions.insert(reflectedPositions.begin(), positions.rbegin(), positions.rend() - 1);
-    auto size = static_cast<int>(positions.size());
-    std::transform(reflectedPositions.begin(), reflectedPositions.begin() + size,
-                   reflectedPositions.begin(),
-                   [](float position) { return (1.f - position) * 0.5; });
-    std::transform(reflectedPositions.begin() + size, reflectedPositions.end(),
-                   reflectedPositions.begin() + size,
-                   [](float position) { return position * 0.5f + 0.5f; });
-    shader =
-        tgfx::Shader::MakeLinearGradient(startPoint, endPoint, reflectedColors, reflectedPositions);
+    shader = tgfx::Shader::MakeLinearGradient(startPoint, endPoint, ramp->reflectedColors,
+                                              ramp->reflectedPositions);
   }
   if (shader) {
     shader = shader->makeWithMatrix(matrix);
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <memory>
 #include "pag/file.h"
 #include "tgfx/core/Color.h"
 #include "tgfx/core/Matrix.h"
@@ -25,6 +26,17 @@
 #include "tgfx/core/Shader.h"
 
 namespace pag {
+/**
+ * The colors and positions baked from the stops of a GradientColor. Gradients with identical stops
+ * share the same ramp across frames, layers and players.
+ */
+struct GradientRamp {
+  std::vector<tgfx::Color> colors;
+  std::vector<float> positions;
+  std::vector<tgfx::Color> reflectedColors;
+  std::vector<float> reflectedPositions;
+};
+
 /**
  * Defines attributes for drawing gradient colors.
  */
@@ -32,9 +44,13 @@ class GradientPaint {
  public:
   GradientPaint() = default;
 
+  /**
+   * Set animated to true if the color or alpha stops change between frames. The ramp is then built
+   * straight from the stops, which skips serializing them into the key of the shared ramp cache.
+   */
   GradientPaint(Enum fillType, Point startPoint, Point endPoint,
                 const GradientColorHandle& gradientColor, const tgfx::Matrix& matrix,
-                bool reverse = false);
+                bool reverse = false, bool animated = false);
 
   std::shared_ptr<tgfx::Shader> getShader() const;
 
@@ -42,8 +58,7 @@ class GradientPaint {
   Enum gradientType = GradientFillType::Linear;
   tgfx::Point startPoint = tgfx::Point::Zero();
   tgfx::Point endPoint = tgfx::Point::Zero();
-  std::vector<tgfx::Color> colors;
-  std::vector<float> positions;
+  std::shared_ptr<const GradientRamp> ramp = nullptr;
   tgfx::Matrix matrix = tgfx::Matrix::I();
 };
 }  // namespace pag
@@ -22,6 +22,7 @@
 
 namespace pag {
 class RenderCache;
+class AlphaMask;
 
 /**
  * This class delays the acquisition of images until they are actually required.
@@ -56,9 +57,34 @@ class ImageProxy {
    */
   virtual std::shared_ptr<tgfx::Image> getImage(RenderCache* cache) const = 0;
 
+  /**
+   * Returns the scale factor at which the image should be decoded if it is displayed at most at
+   * the specified scale factor. The default value is 1.0, which means the proxy does not support
+   * decoding at a reduced size.
+   */
+  virtual float getDecodeScale(float) const {
+    return 1.0f;
+  }
+
+  /**
+   * Returns an AlphaMask of the image for pixel hit tests if the proxy keeps one, which avoids
+   * reading pixels back from the GPU for every hit test. The default value is nullptr.
+   */
+  virtual std::shared_ptr<AlphaMask> getAlphaMask(RenderCache*) const {
+    return nullptr;
+  }
+
  protected:
   virtual std::shared_ptr<tgfx::Image> makeImage(RenderCache* cache) const = 0;
 
+  /**
+   * Makes an image decoded at the specified scale factor, which is always less than 1.0. Only
+   * called if getDecodeScale() returns a value less than 1.0.
+   */
+  virtual std::shared_ptr<tgfx::Image> makeScaledImage(RenderCache* cache, float) const {
+    return makeImage(cache);
+  }
+
   friend class RenderCache;
 };
 }  // namespace pag
@@ -17,14 +17,21 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Picture.h"
+#include <mutex>
 #include <unordered_set>
 #include "base/utils/MatrixUtil.h"
+#include "rendering/caches/PreloadedImageCache.h"
 #include "rendering/caches/RenderCache.h"
+#include "rendering/graphics/ScaledImageGenerator.h"
 #include "tgfx/gpu/Surface.h"
 #include "tgfx/opengl/GLDevice.h"
 #include "tgfx/utils/Clock.h"
 
 namespace pag {
+// Images are rescaled only if the max scale factor is less than 0.7f (half in memory size) to avoid
+// the unnecessary increase of draw calls.
+static constexpr float RESCALE_THRESHOLD = 0.7f;
+
 static std::shared_ptr<tgfx::Image> RescaleImage(tgfx::Context* context,
                                                  std::shared_ptr<tgfx::Image> image,
                                                  float scaleFactor, bool mipMapped) {
@@ -60,6 +67,11 @@ class ImageProxyPicture : public Picture {
     if (snapshot) {
       return snapshot->hitTest(cache, x, y);
     }
+    auto alphaMask = proxy->getAlphaMask(cache);
+    if (alphaMask) {
+      return alphaMask->hitTest(x, y);
+    }
+    // The other pictures without a snapshot are drawn directly and read back one pixel only.
     auto image = proxy->getImage(cache);
     if (image == nullptr) {
       return false;
@@ -69,7 +81,13 @@ class ImageProxyPicture : public Picture {
       return false;
     }
     auto canvas = surface->getCanvas();
-    canvas->setMatrix(tgfx::Matrix::MakeTrans(-x, -y));
+    auto matrix = tgfx::Matrix::MakeTrans(-x, -y);
+    if (image->width() < proxy->width()) {
+      // The image has been decoded at a reduced size, stretch it back to the size of the proxy.
+      matrix.preScale(static_cast<float>(proxy->width()) / static_cast<float>(image->width()),
+                      static_cast<float>(proxy->height()) / static_cast<float>(image->height()));
+    }
+    canvas->setMatrix(matrix);
     canvas->drawImage(std::move(image));
     return surface->getColor(0, 0).alpha > 0;
   }
@@ -87,7 +105,7 @@ class ImageProxyPicture : public Picture {
     // Do not call proxy->getImage() here, which will clear the decoded image in the render cache.
     if (proxy->isTemporary()) {
       auto image = proxy->getImage(cache);
-      canvas->drawImage(std::move(image));
+      drawProxyImage(canvas, std::move(image));
       return;
     }
     auto options = canvas->surfaceOptions();
@@ -99,16 +117,29 @@ class ImageProxyPicture : public Picture {
       }
     }
     auto image = proxy->getImage(cache);
-    canvas->drawImage(std::move(image));
+    drawProxyImage(canvas, std::move(image));
   }
 
  private:
   std::shared_ptr<ImageProxy> proxy = nullptr;
 
+  void drawProxyImage(Canvas* canvas, std::shared_ptr<tgfx::Image> image) const {
+    if (image == nullptr) {
+      return;
+    }
+    if (image->width() >= proxy->width()) {
+      canvas->drawImage(std::move(image));
+      return;
+    }
+    // The image has been decoded at a reduced size, stretch it back to the size of the proxy.
+    auto matrix = tgfx::Matrix::MakeScale(
+        static_cast<float>(proxy->width()) / static_cast<float>(image->width()),
+        static_cast<float>(proxy->height()) / static_cast<float>(image->height()));
+    canvas->drawImage(std::move(image), matrix);
+  }
+
   float getScaleFactor(float maxScaleFactor) const override {
-    // Use RescaleImage() only when the maxScaleFactor is less than 0.7f (half in memory size) to
-    // avoid the unnecessary increase of draw calls.
-    if (maxScaleFactor > 0.7f) {
+    if (maxScaleFactor > RESCALE_THRESHOLD) {
       // set to 1.0f to avoid rescale the image.
       maxScaleFactor = 1.0f;
     }
@@ -121,6 +152,22 @@ class ImageProxyPicture : public Picture {
     if (image == nullptr) {
       return nullptr;
     }
+    if (image->width() < proxy->width()) {
+      // The image has been decoded at a reduced size, upload it directly if it matches the scale
+      // factor.
+      auto width = static_cast<int>(ceilf(static_cast<float>(proxy->width()) * scaleFactor));
+      if (image->width() == width) {
+        image = image->makeTextureImage(cache->getContext());
+      } else {
+        auto imageScale = static_cast<float>(proxy->width()) / static_cast<float>(image->width());
+        image = RescaleImage(cache->getContext(), image, scaleFactor * imageScale, mipmapped);
+      }
+      if (image == nullptr) {
+        return nullptr;
+      }
+      auto snapshot = new Snapshot(image, tgfx::Matrix::MakeScale(1 / scaleFactor));
+      return std::unique_ptr<Snapshot>(snapshot);
+    }
     bool needRescale = !image->isTextureBacked() && scaleFactor != 1.0f;
     if (needRescale) {
       image = RescaleImage(cache->getContext(), image, scaleFactor, mipmapped);
@@ -242,13 +289,53 @@ class DefaultImageProxy : public ImageProxy {
   }
 
  protected:
+  ID assetID = 0;
+  std::shared_ptr<tgfx::Image> image = nullptr;
+
   std::shared_ptr<tgfx::Image> makeImage(RenderCache*) const override {
     return image;
   }
+};
+
+class EncodedImageProxy : public DefaultImageProxy {
+ public:
+  EncodedImageProxy(ID assetID, std::shared_ptr<tgfx::Image> image,
+                    std::shared_ptr<tgfx::ImageCodec> codec)
+      : DefaultImageProxy(assetID, std::move(image)), codec(std::move(codec)) {
+  }
+
+  float getDecodeScale(float maxScaleFactor) const override {
+    if (codec == nullptr) {
+      return 1.0f;
+    }
+    // The snapshot is rescaled from the decoded image on the GPU.
+    return ScaledImageGenerator::GetDecodeScale(maxScaleFactor);
+  }
+
+ protected:
+  std::shared_ptr<tgfx::Image> makeScaledImage(RenderCache*, float scaleFactor) const override {
+    auto generator = ScaledImageGenerator::Make(codec, scaleFactor);
+    if (generator == nullptr) {
+      return image;
+    }
+    auto preloadedImage = PreloadedImageCache::GetInstance()->take(assetID, scaleFactor);
+    if (preloadedImage != nullptr) {
+      return preloadedImage;
+    }
+    auto scaledImage = tgfx::Image::MakeFrom(std::move(generator));
+    if (scaledImage == nullptr) {
+      return image;
+    }
+    return scaledImage->makeOriented(codec->orientation());
+  }
+
+  std::shared_ptr<tgfx::Image> makeImage(RenderCache*) const override {
+    auto preloadedImage = PreloadedImageCache::GetInstance()->take(assetID, 1.0f);
+    return preloadedImage ? preloadedImage : image;
+  }
 
  private:
-  ID assetID = 0;
-  std::shared_ptr<tgfx::Image> image = nullptr;
+  std::shared_ptr<tgfx::ImageCodec> codec = nullptr;
 };
 
 class BackendTextureProxy : public ImageProxy {
@@ -317,6 +404,23 @@ std::shared_ptr<Graphic> Picture::MakeFrom(ID assetID, std::shared_ptr<tgfx::Ima
   return MakeFrom(assetID, std::move(proxy));
 }
 
+std::shared_ptr<Graphic> Picture::MakeFrom(ID assetID, std::shared_ptr<tgfx::Image> image,
+                                           std::shared_ptr<tgfx::Data> encodedData) {
+  if (image == nullptr) {
+    return nullptr;
+  }
+  if (encodedData == nullptr) {
+    return MakeFrom(assetID, std::move(image));
+  }
+  auto codec = tgfx::ImageCodec::MakeFrom(std::move(encodedData));
+  // The alpha-only images are small enough, always decode them at full resolution.
+  if (codec != nullptr && codec->isAlphaOnly()) {
+    codec = nullptr;
+  }
+  auto proxy = std::make_shared<EncodedImageProxy>(assetID, std::move(image), std::move(codec));
+  return MakeFrom(assetID, std::move(proxy));
+}
+
 std::shared_ptr<Graphic> Picture::MakeFrom(ID assetID, std::shared_ptr<ImageProxy> proxy) {
   if (assetID == 0 || proxy == nullptr) {
     return nullptr;
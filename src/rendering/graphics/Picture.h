@@ -22,6 +22,7 @@
 #include "pag/gpu.h"
 #include "rendering/graphics/ImageProxy.h"
 #include "rendering/graphics/Snapshot.h"
+#include "tgfx/core/Data.h"
 #include "tgfx/core/Image.h"
 #include "tgfx/core/Pixmap.h"
 #include "tgfx/gpu/ImageOrigin.h"
@@ -41,6 +42,14 @@ class Picture : public Graphic {
    */
   static std::shared_ptr<Graphic> MakeFrom(ID assetID, std::shared_ptr<tgfx::Image> image);
 
+  /**
+   * Creates a new Picture with specified Image which is decoded from the encodedData. The returned
+   * Picture may decode the encodedData again at a reduced size if it is never displayed at full
+   * resolution. Returns null if the image is null.
+   */
+  static std::shared_ptr<Graphic> MakeFrom(ID assetID, std::shared_ptr<tgfx::Image> image,
+                                           std::shared_ptr<tgfx::Data> encodedData);
+
   /*
    * Creates a new image with specified ImageProxy. Returns nullptr if the proxy is null.
    */
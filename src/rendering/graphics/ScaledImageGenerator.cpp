@@ -0,0 +1,126 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScaledImageGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "tgfx/core/ImageBuffer.h"
+#include "tgfx/utils/Buffer.h"
+
+namespace pag {
+// Images are decoded at a reduced size only if the max scale factor is less than 0.7f (half in
+// memory size).
+static constexpr float DECODE_THRESHOLD = 0.7f;
+// The smallest scale factor an encoded image is decoded at.
+static constexpr float MIN_DECODE_SCALE = 0.125f;
+
+// Averages every source pixel covered by a destination pixel (box filter). Each source pixel is
+// visited once, and averaging premultiplied colors keeps the edges of transparent areas clean.
+static void BoxDownsample(const tgfx::ImageInfo& srcInfo, const uint8_t* srcPixels,
+                          const tgfx::ImageInfo& dstInfo, uint8_t* dstPixels) {
+  auto srcWidth = static_cast<size_t>(srcInfo.width());
+  auto srcHeight = static_cast<size_t>(srcInfo.height());
+  auto dstWidth = static_cast<size_t>(dstInfo.width());
+  auto dstHeight = static_cast<size_t>(dstInfo.height());
+  std::vector<uint32_t> sums(dstWidth * 4);
+  std::vector<size_t> columnStarts(dstWidth + 1);
+  for (size_t x = 0; x <= dstWidth; x++) {
+    columnStarts[x] = x * srcWidth / dstWidth;
+  }
+  for (size_t y = 0; y < dstHeight; y++) {
+    auto top = y * srcHeight / dstHeight;
+    auto bottom = std::max(top + 1, (y + 1) * srcHeight / dstHeight);
+    std::fill(sums.begin(), sums.end(), 0);
+    for (auto row = top; row < bottom; row++) {
+      auto src = srcPixels + row * srcInfo.rowBytes();
+      for (size_t x = 0; x < dstWidth; x++) {
+        auto right = std::max(columnStarts[x] + 1, columnStarts[x + 1]);
+        auto sum = sums.data() + x * 4;
+        for (auto column = columnStarts[x]; column < right; column++) {
+          auto pixel = src + column * 4;
+          sum[0] += pixel[0];
+          sum[1] += pixel[1];
+          sum[2] += pixel[2];
+          sum[3] += pixel[3];
+        }
+      }
+    }
+    auto dst = dstPixels + y * dstInfo.rowBytes();
+    auto rows = static_cast<uint32_t>(bottom - top);
+    for (size_t x = 0; x < dstWidth; x++) {
+      auto columns = std::max(columnStarts[x] + 1, columnStarts[x + 1]) - columnStarts[x];
+      auto count = rows * static_cast<uint32_t>(columns);
+      auto sum = sums.data() + x * 4;
+      for (int i = 0; i < 4; i++) {
+        dst[x * 4 + i] = static_cast<uint8_t>((sum[i] + count / 2) / count);
+      }
+    }
+  }
+}
+
+std::shared_ptr<ScaledImageGenerator> ScaledImageGenerator::Make(
+    std::shared_ptr<tgfx::ImageCodec> codec, float scaleFactor) {
+  if (codec == nullptr || scaleFactor <= 0.0f || scaleFactor >= 1.0f) {
+    return nullptr;
+  }
+  auto width = static_cast<int>(ceilf(static_cast<float>(codec->width()) * scaleFactor));
+  auto height = static_cast<int>(ceilf(static_cast<float>(codec->height()) * scaleFactor));
+  width = std::min(std::max(width, 1), codec->width());
+  height = std::min(std::max(height, 1), codec->height());
+  return std::shared_ptr<ScaledImageGenerator>(
+      new ScaledImageGenerator(std::move(codec), width, height));
+}
+
+float ScaledImageGenerator::GetDecodeScale(float maxScaleFactor) {
+  if (maxScaleFactor <= 0.0f || maxScaleFactor > DECODE_THRESHOLD) {
+    return 1.0f;
+  }
+  // Decode at the nearest power-of-two fraction above the display scale, so that the decoded
+  // image is kept while the display scale changes within the same range.
+  auto decodeScale = 1.0f;
+  while (decodeScale * 0.5f >= maxScaleFactor && decodeScale > MIN_DECODE_SCALE) {
+    decodeScale *= 0.5f;
+  }
+  return decodeScale;
+}
+
+ScaledImageGenerator::ScaledImageGenerator(std::shared_ptr<tgfx::ImageCodec> codec, int width,
+                                           int height)
+    : tgfx::ImageGenerator(width, height), codec(std::move(codec)) {
+}
+
+std::shared_ptr<tgfx::ImageBuffer> ScaledImageGenerator::onMakeBuffer(bool) const {
+  // The codecs can not decode into a subsampled destination, so the full-resolution pixels are
+  // decoded into a temporary buffer which is released right after the downsampling.
+  auto srcInfo = tgfx::ImageInfo::Make(codec->width(), codec->height(),
+                                       tgfx::ColorType::RGBA_8888, tgfx::AlphaType::Premultiplied);
+  auto dstInfo = tgfx::ImageInfo::Make(width(), height(), tgfx::ColorType::RGBA_8888,
+                                       tgfx::AlphaType::Premultiplied);
+  tgfx::Buffer srcBuffer(srcInfo.byteSize());
+  tgfx::Buffer dstBuffer(dstInfo.byteSize());
+  if (srcBuffer.isEmpty() || dstBuffer.isEmpty()) {
+    return nullptr;
+  }
+  if (!codec->readPixels(srcInfo, srcBuffer.data())) {
+    return nullptr;
+  }
+  BoxDownsample(srcInfo, srcBuffer.bytes(), dstInfo, dstBuffer.bytes());
+  return tgfx::ImageBuffer::MakeFrom(dstInfo, dstBuffer.release());
+}
+}  // namespace pag
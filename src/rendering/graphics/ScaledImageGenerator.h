@@ -0,0 +1,58 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "tgfx/core/ImageCodec.h"
+#include "tgfx/core/ImageGenerator.h"
+
+namespace pag {
+/**
+ * ScaledImageGenerator decodes an encoded image into a smaller size. The full-resolution pixels
+ * only live on the decoding thread and are released as soon as they are downsampled, so neither
+ * the image caches nor the GPU ever hold them.
+ */
+class ScaledImageGenerator : public tgfx::ImageGenerator {
+ public:
+  /**
+   * Creates a new ScaledImageGenerator which decodes the codec at the specified scale factor.
+   * Returns nullptr if the codec is nullptr or the scale factor is not in the range (0, 1).
+   */
+  static std::shared_ptr<ScaledImageGenerator> Make(std::shared_ptr<tgfx::ImageCodec> codec,
+                                                    float scaleFactor);
+
+  /**
+   * Returns the scale factor to decode an image which is displayed at the maxScaleFactor at most.
+   * It is the nearest power-of-two fraction above the maxScaleFactor, or 1.0f if decoding at a
+   * reduced size saves too little memory.
+   */
+  static float GetDecodeScale(float maxScaleFactor);
+
+  bool isAlphaOnly() const override {
+    return false;
+  }
+
+ protected:
+  std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(bool tryHardware) const override;
+
+ private:
+  std::shared_ptr<tgfx::ImageCodec> codec = nullptr;
+
+  ScaledImageGenerator(std::shared_ptr<tgfx::ImageCodec> codec, int width, int height);
+};
+}  // namespace pag
@@ -19,12 +19,15 @@
 #include "Snapshot.h"
 #include "base/utils/MatrixUtil.h"
 #include "rendering/caches/RenderCache.h"
-#include "tgfx/gpu/Surface.h"
 
 namespace pag {
 size_t Snapshot::memoryUsage() const {
   auto byesPerPixel = image->isAlphaOnly() ? 1 : 4;
-  return image->width() * image->height() * byesPerPixel;
+  size_t usage = image->width() * image->height() * byesPerPixel;
+  if (alphaMask != nullptr) {
+    usage += alphaMask->memoryUsage();
+  }
+  return usage;
 }
 
 bool Snapshot::hitTest(RenderCache* cache, float x, float y) const {
@@ -32,13 +35,14 @@ bool Snapshot::hitTest(RenderCache* cache, float x, float y) const {
   if (!MapPointInverted(matrix, &local)) {
     return false;
   }
-  auto surface = tgfx::Surface::Make(cache->getContext(), 1, 1);
-  if (surface == nullptr) {
-    return false;
+  if (alphaMask == nullptr) {
+    alphaMask = AlphaMask::Make(cache->getContext(), image);
+    if (alphaMask == nullptr) {
+      return false;
+    }
+    // The snapshot is already counted by the cache, add the memory of the new mask to it.
+    cache->graphicsMemory += alphaMask->memoryUsage();
   }
-  auto canvas = surface->getCanvas();
-  canvas->setMatrix(tgfx::Matrix::MakeTrans(-local.x, -local.y));
-  canvas->drawImage(image);
-  return surface->getColor(0, 0).alpha > 0;
+  return alphaMask->hitTest(local.x, local.y);
 }
 }  // namespace pag
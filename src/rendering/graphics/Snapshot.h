@@ -19,6 +19,7 @@
 #pragma once
 
 #include "pag/types.h"
+#include "rendering/graphics/AlphaMask.h"
 #include "tgfx/core/Image.h"
 #include "tgfx/core/Matrix.h"
 
@@ -61,13 +62,15 @@ class Snapshot {
   /**
    * Evaluates the Snapshot to see if it overlaps or intersects with the specified point. The point
    * is in the coordinate space of the Snapshot. This method always checks against the actual pixels
-   * of the Snapshot.
+   * of the Snapshot, which are read back into a downsampled AlphaMask on the first call. The memory
+   * of the AlphaMask is included in memoryUsage().
    */
   bool hitTest(RenderCache* cache, float x, float y) const;
 
  private:
   std::shared_ptr<tgfx::Image> image = nullptr;
   tgfx::Matrix matrix = tgfx::Matrix::I();
+  mutable std::shared_ptr<AlphaMask> alphaMask = nullptr;
   ID assetID = 0;
   uint64_t makerKey = 0;
   Frame idleFrames = 0;
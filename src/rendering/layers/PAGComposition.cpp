@@ -28,6 +28,7 @@
 #include "rendering/renderers/LayerRenderer.h"
 #include "rendering/utils/LockGuard.h"
 #include "rendering/utils/ScopedLock.h"
+#include "tgfx/utils/Task.h"
 
 namespace pag {
 std::shared_ptr<PAGComposition> PAGComposition::Make(int width, int height) {
@@ -420,17 +421,103 @@ void PAGComposition::draw(Recorder* recorder) {
   if (hasClip()) {
     recorder->saveClip(0, 0, static_cast<float>(_width), static_cast<float>(_height));
   }
-  auto count = static_cast<int>(layers.size());
-  for (int i = 0; i < count; i++) {
-    auto& childLayer = layers[i];
-    if (!childLayer->layerVisible) {
+  drawChildLayers(recorder);
+  if (hasClip()) {
+    recorder->restore();
+  }
+}
+
+// The task overhead outweighs the gain of parallel recording if there are fewer child layers.
+static constexpr size_t MIN_PARALLEL_RECORDING_LAYERS = 2;
+
+// Set on the worker threads while recording child layers, which stops the nested compositions
+// from scheduling more tasks and blocking the worker threads to wait for them.
+static thread_local bool RecordingOnWorker = false;
+
+struct LayerRecording {
+  std::shared_ptr<tgfx::Task> task = nullptr;
+  std::shared_ptr<Graphic> graphic = nullptr;
+};
+
+void PAGComposition::drawChildLayers(Recorder* recorder) {
+  std::vector<PAGLayer*> visibleLayers = {};
+  for (auto& childLayer : layers) {
+    if (childLayer->layerVisible) {
+      visibleLayers.push_back(childLayer.get());
+    }
+  }
+  std::vector<std::shared_ptr<LayerRecording>> recordings(visibleLayers.size());
+  size_t concurrentCount = 0;
+  if (stage != nullptr && stage->parallelRecording() && !RecordingOnWorker) {
+    for (size_t i = 0; i < visibleLayers.size(); i++) {
+      if (CanRecordConcurrently(visibleLayers[i])) {
+        recordings[i] = std::make_shared<LayerRecording>();
+        concurrentCount++;
+      }
+    }
+  }
+  if (concurrentCount < MIN_PARALLEL_RECORDING_LAYERS) {
+    for (auto childLayer : visibleLayers) {
+      DrawChildLayer(recorder, childLayer);
+    }
+    return;
+  }
+  for (size_t i = 0; i < visibleLayers.size(); i++) {
+    auto recording = recordings[i];
+    if (recording == nullptr) {
+      continue;
+    }
+    auto childLayer = visibleLayers[i];
+    recording->task = tgfx::Task::Run([recording, childLayer]() {
+      RecordingOnWorker = true;
+      Recorder layerRecorder = {};
+      DrawChildLayer(&layerRecorder, childLayer);
+      recording->graphic = layerRecorder.makeGraphic();
+      RecordingOnWorker = false;
+    });
+  }
+  // Stitches the recorded graphics in z-order. The child layers that can not be recorded
+  // concurrently are drawn on the current thread in the meantime.
+  for (size_t i = 0; i < visibleLayers.size(); i++) {
+    auto& recording = recordings[i];
+    if (recording == nullptr) {
+      DrawChildLayer(recorder, visibleLayers[i]);
       continue;
     }
-    DrawChildLayer(recorder, childLayer.get());
+    recording->task->wait();
+    recorder->drawGraphic(recording->graphic);
   }
-  if (hasClip()) {
-    recorder->restore();
+}
+
+bool PAGComposition::CanRecordConcurrently(PAGLayer* childLayer) {
+  // The edited layers may hold contents shared with the stage, which are not thread-safe, while
+  // the caches of unedited layers all come from the File and are guarded by their own locks.
+  if (childLayer->contentModified()) {
+    return false;
+  }
+  // The track matte is recorded along with the layer on the same thread.
+  auto trackMatteLayer = childLayer->_trackMatteLayer.get();
+  if (trackMatteLayer != nullptr && !CanRecordConcurrently(trackMatteLayer)) {
+    return false;
+  }
+  if (childLayer->layerType() != LayerType::PreCompose) {
+    return true;
+  }
+  auto pagComposition = static_cast<PAGComposition*>(childLayer);
+  if (pagComposition->layerCache->contentStatic()) {
+    return true;
+  }
+  auto composition = static_cast<PreComposeLayer*>(childLayer->layer)->composition;
+  if (composition->type() != CompositionType::Vector) {
+    // The sequence graphics are cached by the stage, which is not guarded by any lock.
+    return false;
   }
+  for (auto& layer : pagComposition->layers) {
+    if (layer->layerVisible && !CanRecordConcurrently(layer.get())) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void PAGComposition::DrawChildLayer(Recorder* recorder, PAGLayer* childLayer) {
@@ -16,11 +16,20 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <unordered_set>
 #include "base/utils/TimeUtil.h"
 #include "pag/file.h"
 #include "pag/pag.h"
+#include "rendering/caches/ImageBytesCache.h"
+#include "rendering/caches/MemoryBudgetManager.h"
+#include "rendering/caches/PreloadedImageCache.h"
 #include "rendering/utils/LockGuard.h"
 #include "rendering/utils/ScopedLock.h"
+#include "tgfx/utils/Task.h"
 
 namespace pag {
 uint16_t PAGFile::MaxSupportedTagLevel() {
@@ -207,6 +216,114 @@ std::shared_ptr<PAGFile> PAGFile::copyOriginal() {
   return MakeFrom(file);
 }
 
+// Collects the ImageBytes of the image layers visible before the endFrame. The offset is the start
+// frame of the composition in the root timeline. A negative endFrame collects all images.
+static void CollectImageBytes(Composition* composition, Frame offset, Frame endFrame,
+                              float rootFrameRate, std::vector<ImageBytes*>* images,
+                              std::unordered_set<ImageBytes*>* visited) {
+  if (composition == nullptr || composition->type() != CompositionType::Vector) {
+    return;
+  }
+  if (endFrame >= 0 && composition->frameRate != rootFrameRate) {
+    // The frame offsets can not be mapped exactly, collects all images of the composition instead.
+    endFrame = -1;
+  }
+  for (auto layer : static_cast<VectorComposition*>(composition)->layers) {
+    auto layerStart = offset + layer->startTime;
+    if (endFrame >= 0 && (layerStart >= endFrame || layerStart + layer->duration <= 0)) {
+      continue;
+    }
+    if (layer->type() == LayerType::Image) {
+      auto imageBytes = static_cast<ImageLayer*>(layer)->imageBytes;
+      if (imageBytes != nullptr && visited->insert(imageBytes).second) {
+        images->push_back(imageBytes);
+      }
+    } else if (layer->type() == LayerType::PreCompose) {
+      auto preComposeLayer = static_cast<PreComposeLayer*>(layer);
+      CollectImageBytes(preComposeLayer->composition,
+                        layerStart - preComposeLayer->compositionStartTime, endFrame,
+                        rootFrameRate, images, visited);
+    }
+  }
+}
+
+// The preloading tasks share the tgfx task pool with rendering, so only a few of them run at once.
+static constexpr size_t MAX_PRELOAD_TASKS = 4;
+
+namespace {
+struct PreloadState {
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  std::vector<ImageBytes*> images = {};
+  std::atomic<size_t> nextIndex = {0};
+  size_t pendingTasks = 0;
+  bool memoryReserved = false;
+  std::atomic_bool cancelled = {false};
+};
+}  // namespace
+
+bool PAGFile::preload(int64_t duration, int64_t timeout) {
+  PreloadedImageCache::GetInstance()->purgeExpiredImages();
+  auto rootLayer = file->getRootLayer();
+  if (rootLayer == nullptr) {
+    return true;
+  }
+  Frame endFrame = -1;
+  if (duration > 0) {
+    endFrame = TimeToFrame(duration, file->frameRate());
+  }
+  auto state = std::make_shared<PreloadState>();
+  std::unordered_set<ImageBytes*> visited = {};
+  CollectImageBytes(rootLayer->composition, rootLayer->startTime - rootLayer->compositionStartTime,
+                    endFrame, file->frameRate(), &state->images, &visited);
+  if (state->images.empty()) {
+    return true;
+  }
+  auto budgetManager = MemoryBudgetManager::GetInstance();
+  if (budgetManager->budget() > 0) {
+    // Concurrent preloads count against each other until they finish decoding.
+    if (!budgetManager->reserve(state.get(), CalculateGraphicsMemory(file))) {
+      return false;
+    }
+    state->memoryReserved = true;
+  }
+  state->pendingTasks = std::min(state->images.size(), MAX_PRELOAD_TASKS);
+  for (size_t i = 0; i < state->pendingTasks; i++) {
+    // The tasks keep the file alive in case the waiting times out. Once cancelled, they stop after
+    // the image being decoded, and the tasks not started yet return immediately.
+    tgfx::Task::Run([state, owner = file]() {
+      while (!state->cancelled) {
+        auto index = state->nextIndex++;
+        if (index >= state->images.size()) {
+          break;
+        }
+        ImageBytesCache::Preload(state->images[index]);
+      }
+      std::lock_guard<std::mutex> autoLock(state->locker);
+      state->pendingTasks--;
+      if (state->pendingTasks == 0 && state->memoryReserved) {
+        MemoryBudgetManager::GetInstance()->release(state.get());
+      }
+      state->condition.notify_all();
+    });
+  }
+  std::unique_lock<std::mutex> autoLock(state->locker);
+  auto finished = [state]() { return state->pendingTasks == 0; };
+  if (timeout <= 0) {
+    state->condition.wait(autoLock, finished);
+    return true;
+  }
+  if (state->condition.wait_for(autoLock, std::chrono::microseconds(timeout), finished)) {
+    return true;
+  }
+  state->cancelled = true;
+  return false;
+}
+
+size_t PAGFile::bakeTimeline() {
+  return file->bakeTimeline();
+}
+
 bool PAGFile::isPAGFile() const {
   return true;
 }
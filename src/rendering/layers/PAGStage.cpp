@@ -52,6 +52,13 @@ void PAGStage::setCacheScale(float value) {
   _cacheScale = value;
 }
 
+void PAGStage::setCacheScaleFactor(float value) {
+  if (value <= 0 || value > 1.0f) {
+    value = 1.0f;
+  }
+  cacheScaleFactor = value;
+}
+
 std::shared_ptr<PAGComposition> PAGStage::getRootComposition() {
   if (layers.empty()) {
     return nullptr;
@@ -277,11 +284,11 @@ std::unordered_set<ID> PAGStage::getRemovedAssets() {
 }
 
 float PAGStage::getAssetMaxScale(ID assetID) {
-  return getScaleFactor(assetID).first * _cacheScale;
+  return getScaleFactor(assetID).first * _cacheScale * cacheScaleFactor;
 }
 
 float PAGStage::getAssetMinScale(ID assetID) {
-  return getScaleFactor(assetID).second * _cacheScale;
+  return getScaleFactor(assetID).second * _cacheScale * cacheScaleFactor;
 }
 
 std::pair<float, float> PAGStage::getScaleFactor(ID referenceID) {
@@ -53,6 +53,27 @@ class PAGStage : public PAGComposition {
    */
   void setCacheScale(float value);
 
+  /**
+   * Set the factor applied to the cacheScale by the frame budget governor of the player, ranges
+   * from 0.0 to 1.0. The cacheScale() returns the value without this factor.
+   */
+  void setCacheScaleFactor(float value);
+
+  /**
+   * If set to true, the child layers of compositions which do not depend on any edited content are
+   * recorded concurrently on worker threads. The default value is false.
+   */
+  bool parallelRecording() const {
+    return _parallelRecording;
+  }
+
+  /**
+   * Set the value of parallelRecording property.
+   */
+  void setParallelRecording(bool value) {
+    _parallelRecording = value;
+  }
+
   /**
    * Returns the first root composition.
    */
@@ -109,6 +130,8 @@ class PAGStage : public PAGComposition {
 
  private:
   float _cacheScale = 1.0f;
+  float cacheScaleFactor = 1.0f;
+  bool _parallelRecording = false;
   int64_t rootVersion = -1;
   std::unordered_map<PAGLayer*, Frame> layerStartTimeMap = {};
   std::unordered_map<ID, std::vector<PAGLayer*>> layerReferenceMap = {};
@@ -177,7 +177,8 @@ static bool MakeLayerStyleNode(std::vector<FilterNode>& filterNodes, tgfx::Rect&
 static bool MakeMotionBlurNode(std::vector<FilterNode>& filterNodes, tgfx::Rect& clipBounds,
                                const FilterList* filterList, RenderCache* renderCache,
                                tgfx::Rect& filterBounds, tgfx::Point& effectScale) {
-  if (filterList->layer->motionBlur && !filterList->layer->transform3D) {
+  if (filterList->layer->motionBlur && !filterList->layer->transform3D &&
+      renderCache->expensiveFiltersEnabled()) {
     auto filter = renderCache->getMotionBlurFilter();
     if (filter && filter->updateLayer(filterList->layer, filterList->layerFrame)) {
       auto oldBounds = filterBounds;
@@ -194,12 +195,30 @@ static bool MakeMotionBlurNode(std::vector<FilterNode>& filterNodes, tgfx::Rect&
   return true;
 }
 
+// Glows with a radius larger than this value in pixels are skipped when expensive filters are
+// disabled.
+static constexpr float LargeGlowRadius = 20.0f;
+
+static bool IsExpensiveEffect(Effect* effect, Frame layerFrame, const tgfx::Point& effectScale) {
+  if (effect->type() != EffectType::Glow) {
+    return false;
+  }
+  auto glowEffect = static_cast<GlowEffect*>(effect);
+  auto radius = glowEffect->glowRadius->getValueAt(layerFrame);
+  return radius * std::max(effectScale.x, effectScale.y) > LargeGlowRadius;
+}
+
 bool FilterRenderer::MakeEffectNode(std::vector<FilterNode>& filterNodes, tgfx::Rect& clipBounds,
                                     const FilterList* filterList, RenderCache* renderCache,
                                     tgfx::Rect& filterBounds, tgfx::Point& effectScale,
                                     int clipIndex) {
   auto effectIndex = 0;
   for (auto& effect : filterList->effects) {
+    if (!renderCache->expensiveFiltersEnabled() &&
+        IsExpensiveEffect(effect, filterList->layerFrame, effectScale)) {
+      effectIndex++;
+      continue;
+    }
     auto filter = renderCache->getFilterCache(effect);
     if (filter) {
       auto oldBounds = filterBounds;
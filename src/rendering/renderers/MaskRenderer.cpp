@@ -21,27 +21,32 @@
 #include "rendering/utils/PathUtil.h"
 
 namespace pag {
+bool RenderMask(tgfx::Path* maskPath, MaskData* mask, Frame layerFrame) {
+  auto path = mask->maskPath->getValueAt(layerFrame);
+  if (path == nullptr || !path->isClosed() || mask->maskMode == MaskMode::None) {
+    return false;
+  }
+  *maskPath = ToPath(*path);
+  auto expansion = mask->maskExpansion->getValueAt(layerFrame);
+  ExpandPath(maskPath, expansion);
+  if (mask->inverted) {
+    maskPath->toggleInverseFillType();
+  }
+  return true;
+}
+
 void RenderMasks(tgfx::Path* maskContent, const std::vector<MaskData*>& masks, Frame layerFrame) {
   bool isFirst = true;
   for (auto& mask : masks) {
-    auto path = mask->maskPath->getValueAt(layerFrame);
-    if (path == nullptr || !path->isClosed() || mask->maskMode == MaskMode::None) {
+    tgfx::Path maskPath = {};
+    if (!RenderMask(&maskPath, mask, layerFrame)) {
       continue;
     }
-    auto maskPath = ToPath(*path);
-    auto expansion = mask->maskExpansion->getValueAt(layerFrame);
-    ExpandPath(&maskPath, expansion);
-    auto inverted = mask->inverted;
     if (isFirst) {
+      isFirst = false;
       if (mask->maskMode == MaskMode::Subtract) {
-        inverted = !inverted;
+        maskPath.toggleInverseFillType();
       }
-    }
-    if (inverted) {
-      maskPath.toggleInverseFillType();
-    }
-    if (isFirst) {
-      isFirst = false;
       *maskContent = maskPath;
     } else {
       maskContent->addPath(maskPath, ToPathOp(mask->maskMode));
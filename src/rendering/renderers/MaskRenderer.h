@@ -23,5 +23,11 @@
 #include "tgfx/core/Path.h"
 
 namespace pag {
+/**
+ * Evaluates the path of a single mask at the specified layer frame, including the expansion and
+ * the inversion of the mask. Returns false if the mask is not applied at the frame.
+ */
+bool RenderMask(tgfx::Path* maskPath, MaskData* mask, Frame layerFrame);
+
 void RenderMasks(tgfx::Path* maskContent, const std::vector<MaskData*>& masks, Frame layerFrame);
 }
@@ -27,9 +27,10 @@
 #include "rendering/graphics/GradientPaint.h"
 #include "rendering/graphics/Graphic.h"
 #include "rendering/graphics/Shape.h"
+#include "rendering/utils/PathMeasureCache.h"
 #include "rendering/utils/PathUtil.h"
+#include "rendering/utils/StrokeOutlineCache.h"
 #include "tgfx/core/PathEffect.h"
-#include "tgfx/core/PathMeasure.h"
 
 namespace pag {
 
@@ -60,6 +61,8 @@ struct StrokePaint {
   std::vector<float> dashes;
   float dashOffset = 0;
   tgfx::Matrix matrix = tgfx::Matrix::I();
+  // True if any parameter above may be different in another frame.
+  bool animated = false;
 };
 
 class PaintElement : public ElementData {
@@ -109,6 +112,7 @@ class PathElement : public ElementData {
   std::unique_ptr<ElementData> clone() override {
     auto newPath = new PathElement();
     newPath->path = path;
+    newPath->animated = animated;
     return std::unique_ptr<ElementData>(newPath);
   }
 
@@ -117,6 +121,16 @@ class PathElement : public ElementData {
   }
 
   tgfx::Path path;
+  // True if the path may be different in another frame, the shared caches skip animated paths.
+  bool animated = false;
+};
+
+/**
+ * The matrix and alpha of a copy made by a repeater.
+ */
+struct RepeaterInstance {
+  tgfx::Matrix matrix = tgfx::Matrix::I();
+  float alpha = 1.0f;
 };
 
 class GroupElement : public ElementData {
@@ -135,6 +149,8 @@ class GroupElement : public ElementData {
     auto newGroup = new GroupElement();
     newGroup->blendMode = blendMode;
     newGroup->alpha = alpha;
+    newGroup->animated = animated;
+    newGroup->instances = instances;
     for (auto& data : elements) {
       auto element = data->clone().release();
       newGroup->elements.push_back(element);
@@ -143,12 +159,20 @@ class GroupElement : public ElementData {
   }
 
   void applyMatrix(const tgfx::Matrix& matrix) override {
+    if (!instances.empty()) {
+      for (auto& instance : instances) {
+        instance.matrix.postConcat(matrix);
+      }
+      return;
+    }
     for (auto& element : elements) {
       element->applyMatrix(matrix);
     }
   }
 
-  std::vector<tgfx::Path*> pathList() const {
+  std::vector<tgfx::Path*> pathList() {
+    // The paths are about to be edited, every copy needs its own paths from now on.
+    expandInstances();
     std::vector<tgfx::Path*> list;
     for (auto& element : elements) {
       switch (element->type()) {
@@ -168,6 +192,35 @@ class GroupElement : public ElementData {
     return list;
   }
 
+  bool hasAnimatedPath() const {
+    for (auto& element : elements) {
+      if (element->type() == ElementDataType::Path) {
+        if (static_cast<PathElement*>(element)->animated) {
+          return true;
+        }
+      } else if (element->type() == ElementDataType::Group) {
+        if (static_cast<GroupElement*>(element)->hasAnimatedPath()) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Marks all paths in the group as animated, which is called after they are edited by animated
+   * properties.
+   */
+  void markPathsAnimated() {
+    for (auto& element : elements) {
+      if (element->type() == ElementDataType::Path) {
+        static_cast<PathElement*>(element)->animated = true;
+      } else if (element->type() == ElementDataType::Group) {
+        static_cast<GroupElement*>(element)->markPathsAnimated();
+      }
+    }
+  }
+
   void clear() {
     for (auto& element : elements) {
       delete element;
@@ -175,11 +228,71 @@ class GroupElement : public ElementData {
     elements.clear();
   }
 
+  /**
+   * Replaces the instanced child groups with a copy of them for each instance.
+   */
+  void expandInstances() {
+    std::vector<ElementData*> expandedElements = {};
+    for (auto& element : elements) {
+      auto group = element->type() == ElementDataType::Group
+                       ? static_cast<GroupElement*>(element)
+                       : nullptr;
+      if (group == nullptr || group->instances.empty()) {
+        expandedElements.push_back(element);
+        continue;
+      }
+      auto groupInstances = std::move(group->instances);
+      group->instances.clear();
+      for (auto& instance : groupInstances) {
+        auto newGroup = static_cast<GroupElement*>(group->clone().release());
+        newGroup->applyMatrix(instance.matrix);
+        newGroup->alpha *= instance.alpha;
+        expandedElements.push_back(newGroup);
+      }
+      delete group;
+    }
+    elements = expandedElements;
+  }
+
   tgfx::BlendMode blendMode = tgfx::BlendMode::SrcOver;
   float alpha = 1.0f;
+  // True if the matrix of the group varies over time.
+  bool animated = false;
   std::vector<ElementData*> elements;
+  // If not empty, the elements are drawn once for each instance instead of being copied.
+  std::vector<RepeaterInstance> instances;
 };
 
+static bool IsAnimated(const ShapeTransform* transform) {
+  return transform->anchorPoint->animatable() || transform->position->animatable() ||
+         transform->scale->animatable() || transform->skew->animatable() ||
+         transform->skewAxis->animatable() || transform->rotation->animatable();
+}
+
+static bool IsAnimated(const Property<float>* strokeWidth, const Property<float>* miterLimit,
+                       const std::vector<Property<float>*>& dashes,
+                       const Property<float>* dashOffset) {
+  if (strokeWidth->animatable() || miterLimit->animatable()) {
+    return true;
+  }
+  if (dashes.empty()) {
+    return false;
+  }
+  for (auto& dash : dashes) {
+    if (dash->animatable()) {
+      return true;
+    }
+  }
+  return dashOffset->animatable();
+}
+
+static bool IsAnimated(const RepeaterElement* repeater) {
+  auto transform = repeater->transform;
+  return repeater->copies->animatable() || repeater->offset->animatable() ||
+         transform->anchorPoint->animatable() || transform->position->animatable() ||
+         transform->scale->animatable() || transform->rotation->animatable();
+}
+
 void RectangleToPath(RectangleElement* rectangle, tgfx::Path* path, Frame frame) {
   auto size = rectangle->size->getValueAt(frame);
   auto position = rectangle->position->getValueAt(frame);
@@ -337,7 +450,7 @@ void ShapePathToPath(ShapePathElement* shapePath, tgfx::Path* path, Frame frame)
   if (pathData == nullptr) {
     return;
   }
-  path->addPath(ToPath(*pathData));
+  AddToPath(*pathData, path);
 }
 
 tgfx::PathFillType ToPathFillType(Enum rule) {
@@ -377,6 +490,8 @@ PaintElement* StrokeToPaint(StrokeElement* stroke, const tgfx::Matrix& matrix, F
     paint->stroke.dashOffset = stroke->dashOffset->getValueAt(frame);
   }
   paint->stroke.matrix = matrix;
+  paint->stroke.animated = IsAnimated(stroke->strokeWidth, stroke->miterLimit, stroke->dashes,
+                                      stroke->dashOffset);
   return paint;
 }
 
@@ -391,7 +506,8 @@ PaintElement* GradientFillToPaint(GradientFillElement* fill, const tgfx::Matrix&
   paint->compositeOrder = fill->composite;
   paint->gradient =
       GradientPaint(fill->fillType, fill->startPoint->getValueAt(frame),
-                    fill->endPoint->getValueAt(frame), fill->colors->getValueAt(frame), matrix);
+                    fill->endPoint->getValueAt(frame), fill->colors->getValueAt(frame), matrix,
+                    false, fill->colors->animatable());
   paint->pathFillType = ToPathFillType(fill->fillRule);
 
   return paint;
@@ -417,9 +533,12 @@ PaintElement* GradientStrokeToPaint(GradientStrokeElement* stroke, const tgfx::M
     paint->stroke.dashOffset = stroke->dashOffset->getValueAt(frame);
   }
   paint->stroke.matrix = matrix;
+  paint->stroke.animated = IsAnimated(stroke->strokeWidth, stroke->miterLimit, stroke->dashes,
+                                      stroke->dashOffset);
   paint->gradient =
       GradientPaint(stroke->fillType, stroke->startPoint->getValueAt(frame),
-                    stroke->endPoint->getValueAt(frame), stroke->colors->getValueAt(frame), matrix);
+                    stroke->endPoint->getValueAt(frame), stroke->colors->getValueAt(frame), matrix,
+                    false, stroke->colors->animatable());
   return paint;
 }
 
@@ -429,13 +548,13 @@ struct TrimSegment {
 };
 
 void ApplyTrimPathIndividually(const std::vector<tgfx::Path*>& pathList,
-                               std::vector<TrimSegment> segments) {
+                               std::vector<TrimSegment> segments, bool animated) {
   float totalLength = 0;
-  std::vector<std::unique_ptr<tgfx::PathMeasure>> measureList;
+  std::vector<std::shared_ptr<MeasuredPath>> measureList;
   for (auto& path : pathList) {
-    auto pathMeasure = tgfx::PathMeasure::MakeFrom(*path);
-    totalLength += pathMeasure->getLength();
-    measureList.push_back(std::move(pathMeasure));
+    auto measuredPath = PathMeasureCache::Get(*path, animated);
+    totalLength += measuredPath->length();
+    measureList.push_back(std::move(measuredPath));
   }
   for (auto& segment : segments) {
     segment.start *= totalLength;
@@ -444,9 +563,9 @@ void ApplyTrimPathIndividually(const std::vector<tgfx::Path*>& pathList,
   float addedLength = 0;
   int index = 0;
   tgfx::Path tempPath = {};
-  for (auto& pathMeasure : measureList) {
+  for (auto& measuredPath : measureList) {
     auto& path = pathList[index++];
-    auto pathLength = pathMeasure->getLength();
+    auto pathLength = measuredPath->length();
     if (pathLength == 0) {
       continue;
     }
@@ -456,7 +575,7 @@ void ApplyTrimPathIndividually(const std::vector<tgfx::Path*>& pathList,
         continue;
       }
       intersect = true;
-      pathMeasure->getSegment(segment.start - addedLength, segment.end - addedLength, &tempPath);
+      measuredPath->getSegment(segment.start - addedLength, segment.end - addedLength, &tempPath);
     }
     if (intersect) {
       *path = tempPath;
@@ -469,7 +588,7 @@ void ApplyTrimPathIndividually(const std::vector<tgfx::Path*>& pathList,
 }
 
 void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*>& pathList, float start,
-                    float end, bool reversed) {
+                    float end, bool reversed, bool animated) {
   if (start == 0 && end == 1) {
     return;
   }
@@ -489,15 +608,15 @@ void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*>& pathL
   if (trimPaths->trimType == TrimPathsType::Simultaneously) {
     tgfx::Path tempPath = {};
     for (auto& path : pathList) {
-      auto pathMeasure = tgfx::PathMeasure::MakeFrom(*path);
-      auto length = pathMeasure->getLength();
+      auto measuredPath = PathMeasureCache::Get(*path, animated);
+      auto length = measuredPath->length();
       if (length == 0) {
         continue;
       }
       for (auto segment : segments) {
         auto startD = length * segment.start;
         auto endD = length * segment.end;
-        pathMeasure->getSegment(startD, endD, &tempPath);
+        measuredPath->getSegment(startD, endD, &tempPath);
       }
       *path = tempPath;
       tempPath.reset();
@@ -507,11 +626,12 @@ void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*>& pathL
     if (reversed) {
       std::reverse(list.begin(), list.end());
     }
-    ApplyTrimPathIndividually(list, segments);
+    ApplyTrimPathIndividually(list, segments, animated);
   }
 }
 
-void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*> pathList, Frame frame) {
+void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*> pathList, Frame frame,
+                    bool animated) {
   auto start = trimPaths->start->getValueAt(frame);
   auto end = trimPaths->end->getValueAt(frame);
   auto offset = fmodf(trimPaths->offset->getValueAt(frame), 360.0f) / 360.0f;
@@ -538,7 +658,7 @@ void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*> pathLi
     start += 1.0f;
     end += 1.0f;
   }
-  ApplyTrimPaths(trimPaths, pathList, start, end, reversed);
+  ApplyTrimPaths(trimPaths, pathList, start, end, reversed, animated);
 }
 
 void ApplyMergePaths(MergePathsElement* mergePaths, GroupElement* group) {
@@ -570,12 +690,30 @@ void ApplyMergePaths(MergePathsElement* mergePaths, GroupElement* group) {
     auto path = pathList[i];
     tempPath.addPath(*path, pathOp);
   }
+  auto animated = group->hasAnimatedPath();
   group->clear();
   auto pathElement = new PathElement();
   pathElement->path = tempPath;
+  pathElement->animated = animated;
   group->elements.push_back(pathElement);
 }
 
+static bool HasGradientPaint(const GroupElement* group) {
+  for (auto& element : group->elements) {
+    if (element->type() == ElementDataType::Group) {
+      if (HasGradientPaint(static_cast<GroupElement*>(element))) {
+        return true;
+      }
+    } else if (element->type() == ElementDataType::Paint) {
+      auto paintType = static_cast<PaintElement*>(element)->paintType;
+      if (paintType == PaintType::GradientFill || paintType == PaintType::GradientStroke) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void ApplyRepeater(RepeaterElement* repeater, GroupElement* group, Frame frame) {
   auto copies = repeater->copies->getValueAt(frame);
   if (copies < 0) {
@@ -585,6 +723,9 @@ void ApplyRepeater(RepeaterElement* repeater, GroupElement* group, Frame frame)
     group->clear();
     return;
   }
+  if (IsAnimated(repeater)) {
+    group->markPathsAnimated();
+  }
   auto maxCount = ceilf(copies);
   auto offset = repeater->offset->getValueAt(frame);
   auto anchorPoint = repeater->transform->anchorPoint->getValueAt(frame);
@@ -594,31 +735,51 @@ void ApplyRepeater(RepeaterElement* repeater, GroupElement* group, Frame frame)
   auto startOpacity = repeater->transform->startOpacity->getValueAt(frame);
   auto endOpacity = repeater->transform->endOpacity->getValueAt(frame);
   float i = 0;
-  std::vector<ElementData*> elements = {};
+  bool invertible = true;
+  std::vector<RepeaterInstance> instances = {};
   while (i < maxCount) {
     auto progress = i + offset;
-    auto newGroup = static_cast<GroupElement*>(group->clone().release());
-    if (repeater->composite == RepeaterOrder::Below) {
-      elements.push_back(newGroup);
-    } else {
-      elements.insert(elements.begin(), newGroup);
-    }
+    RepeaterInstance instance = {};
     if (i == maxCount - 1) {
       if (progress != copies + offset) {
-        newGroup->alpha *= copies - i;
+        instance.alpha *= copies - i;
       }
     }
-    auto matrix = tgfx::Matrix::I();
+    auto& matrix = instance.matrix;
     matrix.postTranslate(-anchorPoint.x, -anchorPoint.y);
     matrix.postScale(powf(scale.x, progress), powf(scale.y, progress));
     matrix.postRotate(rotation * progress);
     matrix.postTranslate(position.x * progress, position.y * progress);
     matrix.postTranslate(anchorPoint.x, anchorPoint.y);
-    newGroup->applyMatrix(matrix);
+    auto inverted = tgfx::Matrix::I();
+    invertible = invertible && matrix.invert(&inverted);
     auto newOpacity = Interpolate(startOpacity, endOpacity, progress / maxCount);
-    newGroup->alpha *= ToAlpha(newOpacity);
+    instance.alpha *= ToAlpha(newOpacity);
+    if (repeater->composite == RepeaterOrder::Below) {
+      instances.push_back(instance);
+    } else {
+      instances.insert(instances.begin(), instance);
+    }
     i += 1.0f;
   }
+  // Gradients do not move with the copies, and strokes of collapsed copies are not transformed
+  // along with their paths, both of them require real copies of the paths.
+  if (invertible && !HasGradientPaint(group)) {
+    auto baseGroup = new GroupElement();
+    baseGroup->blendMode = group->blendMode;
+    baseGroup->alpha = group->alpha;
+    baseGroup->elements = group->elements;
+    baseGroup->instances = std::move(instances);
+    group->elements = {baseGroup};
+    return;
+  }
+  std::vector<ElementData*> elements = {};
+  for (auto& instance : instances) {
+    auto newGroup = static_cast<GroupElement*>(group->clone().release());
+    newGroup->applyMatrix(instance.matrix);
+    newGroup->alpha *= instance.alpha;
+    elements.push_back(newGroup);
+  }
   group->clear();
   group->elements = elements;
 }
@@ -685,39 +846,54 @@ void RenderElements_ShapeGroup(ShapeElement* element, const tgfx::Matrix& parent
   auto group = new GroupElement();
   group->alpha = transform.alpha;
   group->blendMode = ToTGFXBlend(shape->blendMode);
+  group->animated = parentGroup->animated || IsAnimated(shape->transform);
   RenderElements(shape->elements, transform.matrix, group, frame);
   parentGroup->elements.push_back(group);
 }
 
 void RenderElements_Rectangle(ShapeElement* element, const tgfx::Matrix& parentMatrix,
                               GroupElement* parentGroup, Frame frame) {
+  auto rectangle = static_cast<RectangleElement*>(element);
   auto pathElement = new PathElement();
-  RectangleToPath(static_cast<RectangleElement*>(element), &pathElement->path, frame);
+  RectangleToPath(rectangle, &pathElement->path, frame);
   pathElement->path.transform(parentMatrix);
+  pathElement->animated = parentGroup->animated || rectangle->size->animatable() ||
+                          rectangle->position->animatable() || rectangle->roundness->animatable();
   parentGroup->elements.push_back(pathElement);
 }
 
 void RenderElements_Ellipse(ShapeElement* element, const tgfx::Matrix& parentMatrix,
                             GroupElement* parentGroup, Frame frame) {
+  auto ellipse = static_cast<EllipseElement*>(element);
   auto pathElement = new PathElement();
-  EllipseToPath(static_cast<EllipseElement*>(element), &pathElement->path, frame);
+  EllipseToPath(ellipse, &pathElement->path, frame);
   pathElement->path.transform(parentMatrix);
+  pathElement->animated = parentGroup->animated || ellipse->size->animatable() ||
+                          ellipse->position->animatable();
   parentGroup->elements.push_back(pathElement);
 }
 
 void RenderElements_PolyStar(ShapeElement* element, const tgfx::Matrix& parentMatrix,
                              GroupElement* parentGroup, Frame frame) {
+  auto polyStar = static_cast<PolyStarElement*>(element);
   auto pathElement = new PathElement();
-  PolyStarToPath(static_cast<PolyStarElement*>(element), &pathElement->path, frame);
+  PolyStarToPath(polyStar, &pathElement->path, frame);
   pathElement->path.transform(parentMatrix);
+  pathElement->animated =
+      parentGroup->animated || polyStar->points->animatable() ||
+      polyStar->position->animatable() || polyStar->rotation->animatable() ||
+      polyStar->innerRadius->animatable() || polyStar->outerRadius->animatable() ||
+      polyStar->innerRoundness->animatable() || polyStar->outerRoundness->animatable();
   parentGroup->elements.push_back(pathElement);
 }
 
 void RenderElements_ShapePath(ShapeElement* element, const tgfx::Matrix& parentMatrix,
                               GroupElement* parentGroup, Frame frame) {
+  auto shapePath = static_cast<ShapePathElement*>(element);
   auto pathElement = new PathElement();
-  ShapePathToPath(static_cast<ShapePathElement*>(element), &pathElement->path, frame);
+  ShapePathToPath(shapePath, &pathElement->path, frame);
   pathElement->path.transform(parentMatrix);
+  pathElement->animated = parentGroup->animated || shapePath->shapePath->animatable();
   parentGroup->elements.push_back(pathElement);
 }
 
@@ -735,6 +911,7 @@ void RenderElements_Stroke(ShapeElement* element, const tgfx::Matrix& parentMatr
   auto stroke = static_cast<StrokeElement*>(element);
   auto paint = StrokeToPaint(stroke, parentMatrix, frame);
   if (paint != nullptr) {
+    paint->stroke.animated = paint->stroke.animated || parentGroup->animated;
     parentGroup->elements.push_back(paint);
   }
 }
@@ -753,6 +930,7 @@ void RenderElements_GradientStroke(ShapeElement* element, const tgfx::Matrix& pa
   auto stroke = static_cast<GradientStrokeElement*>(element);
   auto paint = GradientStrokeToPaint(stroke, parentMatrix, frame);
   if (paint != nullptr) {
+    paint->stroke.animated = paint->stroke.animated || parentGroup->animated;
     parentGroup->elements.push_back(paint);
   }
 }
@@ -769,13 +947,22 @@ void RenderElements_Repeater(ShapeElement* element, const tgfx::Matrix&, GroupEl
 
 void RenderElements_TrimPaths(ShapeElement* element, const tgfx::Matrix&, GroupElement* parentGroup,
                               Frame frame) {
-  ApplyTrimPaths(static_cast<TrimPathsElement*>(element), parentGroup->pathList(), frame);
+  auto trimPaths = static_cast<TrimPathsElement*>(element);
+  auto pathList = parentGroup->pathList();
+  ApplyTrimPaths(trimPaths, pathList, frame, parentGroup->hasAnimatedPath());
+  if (trimPaths->start->animatable() || trimPaths->end->animatable() ||
+      trimPaths->offset->animatable()) {
+    parentGroup->markPathsAnimated();
+  }
 }
 
 void RenderElements_RoundCorners(ShapeElement* element, const tgfx::Matrix& parentMatrix,
                                  GroupElement* parentGroup, Frame frame) {
-  ApplyRoundCorners(static_cast<RoundCornersElement*>(element), parentMatrix,
-                    parentGroup->pathList(), frame);
+  auto roundCorners = static_cast<RoundCornersElement*>(element);
+  ApplyRoundCorners(roundCorners, parentMatrix, parentGroup->pathList(), frame);
+  if (roundCorners->radius->animatable()) {
+    parentGroup->markPathsAnimated();
+  }
 }
 
 using RenderElementsHandler = void(ShapeElement* element, const tgfx::Matrix& parentMatrix,
@@ -827,7 +1014,23 @@ std::unique_ptr<tgfx::PathEffect> CreateDashEffect(const std::vector<float>& das
   return dashEffect;
 }
 
-void ApplyStrokeToPath(tgfx::Path* path, const StrokePaint& stroke) {
+void ApplyStrokeToPath(tgfx::Path* path, const StrokePaint& stroke, bool pathAnimated) {
+  // A key copies the whole path, skip building one if the next frame strokes another outline.
+  auto cacheable = !pathAnimated && !stroke.animated;
+  StrokeKey key = {};
+  if (cacheable) {
+    key.path = *path;
+    key.strokeWidth = stroke.strokeWidth;
+    key.lineCap = stroke.lineCap;
+    key.lineJoin = stroke.lineJoin;
+    key.miterLimit = stroke.miterLimit;
+    key.dashes = stroke.dashes;
+    key.dashOffset = stroke.dashOffset;
+    key.matrix = stroke.matrix;
+    if (StrokeOutlineCache::Find(key, path)) {
+      return;
+    }
+  }
   std::vector<std::unique_ptr<tgfx::PathEffect>> effects;
   if (!stroke.dashes.empty()) {
     auto dashEffect = CreateDashEffect(stroke.dashes, stroke.dashOffset);
@@ -857,13 +1060,17 @@ void ApplyStrokeToPath(tgfx::Path* path, const StrokePaint& stroke) {
   if (applyMatrix) {
     path->transform(stroke.matrix);
   }
+  if (cacheable) {
+    StrokeOutlineCache::Add(key, *path);
+  }
 }
 
-std::shared_ptr<Graphic> RenderShape(ID assetID, PaintElement* paint, tgfx::Path* path) {
+std::shared_ptr<Graphic> RenderShape(ID assetID, PaintElement* paint, tgfx::Path* path,
+                                     bool pathAnimated) {
   tgfx::Path shapePath = *path;
   auto paintType = paint->paintType;
   if (paintType == PaintType::Stroke || paintType == PaintType::GradientStroke) {
-    ApplyStrokeToPath(&shapePath, paint->stroke);
+    ApplyStrokeToPath(&shapePath, paint->stroke, pathAnimated);
   } else if (shapePath.isLine()) {
     return nullptr;
   }
@@ -880,17 +1087,48 @@ std::shared_ptr<Graphic> RenderShape(ID assetID, PaintElement* paint, tgfx::Path
   return Graphic::MakeCompose(shape, modifier);
 }
 
-std::shared_ptr<Graphic> RenderShape(ID assetID, GroupElement* group, tgfx::Path* path) {
+std::shared_ptr<Graphic> RenderShape(ID assetID, GroupElement* group, tgfx::Path* path,
+                                     bool* pathAnimated);
+
+void RenderInstances(ID assetID, GroupElement* group, tgfx::Path* path, bool* pathAnimated,
+                     std::vector<std::shared_ptr<Graphic>>* contents) {
+  // Records the geometry once, and replays it with the matrix of each copy.
+  auto instances = std::move(group->instances);
+  group->instances.clear();
+  auto blendMode = group->blendMode;
+  auto alpha = group->alpha;
+  group->blendMode = tgfx::BlendMode::SrcOver;
+  group->alpha = 1.0f;
+  tgfx::Path basePath = {};
+  bool baseAnimated = false;
+  auto baseShape = RenderShape(assetID, group, &basePath, &baseAnimated);
+  *pathAnimated = *pathAnimated || baseAnimated;
+  for (auto& instance : instances) {
+    auto instancePath = basePath;
+    instancePath.transform(instance.matrix);
+    path->addPath(instancePath);
+    auto shape = Graphic::MakeCompose(baseShape, instance.matrix);
+    auto modifier = Modifier::MakeBlend(alpha * instance.alpha, blendMode);
+    shape = Graphic::MakeCompose(shape, modifier);
+    if (shape) {
+      contents->insert(contents->begin(), shape);
+    }
+  }
+}
+
+std::shared_ptr<Graphic> RenderShape(ID assetID, GroupElement* group, tgfx::Path* path,
+                                     bool* pathAnimated) {
   std::vector<std::shared_ptr<Graphic>> contents = {};
   for (auto& element : group->elements) {
     switch (element->type()) {
       case ElementDataType::Path: {
         auto pathElement = reinterpret_cast<PathElement*>(element);
         path->addPath(pathElement->path);
+        *pathAnimated = *pathAnimated || pathElement->animated;
       } break;
       case ElementDataType::Paint: {
         auto paint = reinterpret_cast<PaintElement*>(element);
-        auto shape = RenderShape(assetID, paint, path);
+        auto shape = RenderShape(assetID, paint, path, *pathAnimated);
         if (shape) {
           if (paint->compositeOrder == CompositeOrder::AbovePreviousInSameGroup) {
             contents.push_back(shape);
@@ -900,9 +1138,16 @@ std::shared_ptr<Graphic> RenderShape(ID assetID, GroupElement* group, tgfx::Path
         }
       } break;
       case ElementDataType::Group: {
+        auto childGroup = static_cast<GroupElement*>(element);
+        if (!childGroup->instances.empty()) {
+          RenderInstances(assetID, childGroup, path, pathAnimated, &contents);
+          break;
+        }
         tgfx::Path tempPath = {};
-        auto shape = RenderShape(assetID, static_cast<GroupElement*>(element), &tempPath);
+        bool tempAnimated = false;
+        auto shape = RenderShape(assetID, childGroup, &tempPath, &tempAnimated);
         path->addPath(tempPath);
+        *pathAnimated = *pathAnimated || tempAnimated;
         if (shape) {
           contents.insert(contents.begin(), shape);
         }
@@ -920,6 +1165,7 @@ std::shared_ptr<Graphic> RenderShapes(ID assetID, const std::vector<ShapeElement
   auto matrix = tgfx::Matrix::I();
   RenderElements(contents, matrix, &rootGroup, layerFrame);
   tgfx::Path tempPath = {};
-  return RenderShape(assetID, &rootGroup, &tempPath);
+  bool pathAnimated = false;
+  return RenderShape(assetID, &rootGroup, &tempPath, &pathAnimated);
 }
 }  // namespace pag
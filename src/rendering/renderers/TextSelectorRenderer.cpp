@@ -17,6 +17,8 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "TextSelectorRenderer.h"
+#include <map>
+#include <mutex>
 #include "base/utils/BezierEasing.h"
 #include "base/utils/MathUtil.h"
 
@@ -38,6 +40,19 @@ float TextSelectorRenderer::CalculateFactorFromSelectors(
   return totalFactor;
 }
 
+void TextSelectorRenderer::CalculateFactorsFromSelectors(
+    const std::vector<TextSelectorRenderer*>& selectorRenderers, size_t textCount,
+    std::vector<float>* factors) {
+  factors->assign(textCount, 1.0f);
+  std::vector<float> selectorFactors(textCount, 0.0f);
+  bool isFirstSelector = true;
+  for (auto selectorRenderer : selectorRenderers) {
+    selectorRenderer->calculateFactors(selectorFactors.data());
+    selectorRenderer->overlayFactors(factors->data(), selectorFactors.data(), isFirstSelector);
+    isFirstSelector = false;
+  }
+}
+
 static float OverlayFactorByMode(float oldFactor, float factor, Enum mode) {
   float newFactor;
   switch (mode) {
@@ -85,6 +100,57 @@ float TextSelectorRenderer::overlayFactor(float oldFactor, float factor, bool is
   return newFactor;
 }
 
+template <typename OverlayFunc>
+static void OverlayFactors(float* totalFactors, const float* factors, size_t count,
+                           OverlayFunc overlay) {
+  for (size_t i = 0; i < count; i++) {
+    auto newFactor = overlay(totalFactors[i], factors[i]);
+    totalFactors[i] = std::min(std::max(newFactor, -1.0f), 1.0f);
+  }
+}
+
+// 批量叠加选择器，在循环外确定叠加模式，方便编译器向量化
+void TextSelectorRenderer::overlayFactors(float* totalFactors, const float* factors,
+                                          bool isFirstSelector) const {
+  if (isFirstSelector && mode != TextSelectorMode::Subtract) {
+    OverlayFactors(totalFactors, factors, textCount, [](float, float factor) { return factor; });
+    return;
+  }
+  switch (mode) {
+    case TextSelectorMode::Subtract:
+      OverlayFactors(totalFactors, factors, textCount, [](float oldFactor, float factor) {
+        return factor >= 0.0f ? oldFactor * (1.0f - factor) : oldFactor * (-1.0f - factor);
+      });
+      break;
+    case TextSelectorMode::Intersect:
+      OverlayFactors(totalFactors, factors, textCount,
+                     [](float oldFactor, float factor) { return oldFactor * factor; });
+      break;
+    case TextSelectorMode::Min:
+      OverlayFactors(totalFactors, factors, textCount,
+                     [](float oldFactor, float factor) { return std::min(oldFactor, factor); });
+      break;
+    case TextSelectorMode::Max:
+      OverlayFactors(totalFactors, factors, textCount,
+                     [](float oldFactor, float factor) { return std::max(oldFactor, factor); });
+      break;
+    case TextSelectorMode::Difference:
+      OverlayFactors(totalFactors, factors, textCount,
+                     [](float oldFactor, float factor) { return fabsf(oldFactor - factor); });
+      break;
+    default:  // TextSelectorMode::Add:
+      OverlayFactors(totalFactors, factors, textCount,
+                     [](float oldFactor, float factor) { return oldFactor + factor; });
+      break;
+  }
+}
+
+void TextSelectorRenderer::calculateFactors(float* factors) {
+  for (size_t i = 0; i < textCount; i++) {
+    factors[i] = calculateFactorByIndex(i, nullptr);
+  }
+}
+
 //
 // 因无法获取AE的随机策略，所以随机的具体值也和AE不一样，但因需要获取准确的FirtBaseline，
 // 而Position动画会影响插件里FirtBaseline的获取，所以我们需要得到第一个字符的准确位置，
@@ -117,7 +183,7 @@ static int GetRandomIndex(int textCount) {
   return 0;
 }
 
-void TextSelectorRenderer::calculateRandomIndexs(uint16_t seed) {
+static std::shared_ptr<const std::vector<int>> MakeRandomIndexs(uint16_t seed, size_t textCount) {
   srand(seed);  // 重置随机种子
   std::vector<std::pair<int, int>> randList;
   for (size_t i = 0; i < textCount; i++) {
@@ -129,8 +195,9 @@ void TextSelectorRenderer::calculateRandomIndexs(uint16_t seed) {
             [](const std::pair<int, int>& a, std::pair<int, int>& b) { return a.first < b.first; });
 
   // 随机数排序后的序号作为真正的顺序
+  auto randomIndexs = std::make_shared<std::vector<int>>();
   for (size_t i = 0; i < textCount; i++) {
-    randomIndexs.push_back(randList[i].second);
+    randomIndexs->push_back(randList[i].second);
   }
 
   if (seed == 0 && textCount > 1) {
@@ -139,12 +206,34 @@ void TextSelectorRenderer::calculateRandomIndexs(uint16_t seed) {
     auto m = GetRandomIndex(static_cast<int>(textCount));
     size_t k = 0;
     do {
-      if (randomIndexs[k] == m) {
+      if ((*randomIndexs)[k] == m) {
         break;
       }
     } while (++k < textCount);
-    std::swap(randomIndexs[0], randomIndexs[k]);
+    std::swap((*randomIndexs)[0], (*randomIndexs)[k]);
+  }
+  return randomIndexs;
+}
+
+// 随机序号只与种子和字符数有关，缓存起来避免每帧重新生成和排序
+static constexpr size_t MAX_RANDOM_INDEXS_CACHE_COUNT = 64;
+static std::mutex randomIndexsLocker = {};
+static std::map<std::pair<uint16_t, size_t>, std::shared_ptr<const std::vector<int>>>
+    randomIndexsCache = {};
+
+void TextSelectorRenderer::calculateRandomIndexs(uint16_t seed) {
+  std::lock_guard<std::mutex> autoLock(randomIndexsLocker);
+  auto key = std::make_pair(seed, textCount);
+  auto result = randomIndexsCache.find(key);
+  if (result != randomIndexsCache.end()) {
+    randomIndexs = result->second;
+    return;
   }
+  if (randomIndexsCache.size() >= MAX_RANDOM_INDEXS_CACHE_COUNT) {
+    randomIndexsCache.clear();
+  }
+  randomIndexs = MakeRandomIndexs(seed, textCount);
+  randomIndexsCache[key] = randomIndexs;
 }
 
 // 读取摆动选择器
@@ -188,6 +277,21 @@ float WigglySelectorRenderer::calculateFactorByIndex(size_t index, bool* pBiasFl
   return factor;
 }
 
+void WigglySelectorRenderer::calculateFactors(float* factors) {
+  // 与 calculateFactorByIndex() 的公式相同，把与字符序号无关的部分提到循环外面
+  auto temporalSeed = wigglesPerSecond / 2.0 * (frame + temporalPhase / 30.f) / 24.0f;
+  auto spatialScale = 13.73f * (1.0f - correlation);
+  auto spatialOffset = spatialPhase / 80.0f;
+  auto randomOffset = randomSeed / 3.13f;
+  for (size_t index = 0; index < textCount; index++) {
+    auto spatialSeed = (spatialScale * index + spatialOffset) / 21.13f;
+    auto seed = (spatialSeed + temporalSeed + randomOffset) * 2 * M_PI;
+    auto factor = cos(seed) * cos(seed / 7 + M_PI / 5);
+    factor = std::min(std::max(factor, -1.0), 1.0);
+    factors[index] = static_cast<float>((factor + 1.0f) / 2 * (maxAmount - minAmount) + minAmount);
+  }
+}
+
 // 读取范围选择器
 RangeSelectorRenderer::RangeSelectorRenderer(const TextRangeSelector* selector, size_t textCount,
                                              Frame frame)
@@ -444,7 +548,7 @@ float RangeSelectorRenderer::calculateFactorByIndex(size_t index, bool* pBiasFla
     return 0.0f;
   }
   if (randomizeOrder) {
-    index = randomIndexs[index];  // 从随机过后的列表中获取新的序号。
+    index = (*randomIndexs)[index];  // 从随机过后的列表中获取新的序号。
   }
   auto textStart = static_cast<float>(index) / textCount;
   auto textEnd = static_cast<float>(index + 1) / textCount;
@@ -479,4 +583,52 @@ float RangeSelectorRenderer::calculateFactorByIndex(size_t index, bool* pBiasFla
   calculateBiasFlag(pBiasFlag);
   return factor;
 }
+
+template <typename ShapeFunc>
+void RangeSelectorRenderer::calculateFactorsByShape(float* factors, ShapeFunc shapeFunc) const {
+  for (size_t i = 0; i < textCount; i++) {
+    size_t index = randomizeOrder ? (*randomIndexs)[i] : i;
+    auto textStart = static_cast<float>(index) / textCount;
+    auto textEnd = static_cast<float>(index + 1) / textCount;
+    auto factor = shapeFunc(textStart, textEnd);
+    factors[i] = std::min(std::max(factor, 0.0f), 1.0f) * amount;
+  }
+}
+
+// 计算所有字符的范围因子，在循环外确定形状，方便编译器向量化
+void RangeSelectorRenderer::calculateFactors(float* factors) {
+  switch (shape) {
+    case TextRangeSelectorShape::RampUp:  // 上斜坡
+      calculateFactorsByShape(factors, [this](float textStart, float textEnd) {
+        return CalculateRangeFactorRampUp(textStart, textEnd, rangeStart, rangeEnd);
+      });
+      break;
+    case TextRangeSelectorShape::RampDown:  // 下斜坡
+      calculateFactorsByShape(factors, [this](float textStart, float textEnd) {
+        return CalculateRangeFactorRampDown(textStart, textEnd, rangeStart, rangeEnd);
+      });
+      break;
+    case TextRangeSelectorShape::Triangle:  // 三角形
+      calculateFactorsByShape(factors, [this](float textStart, float textEnd) {
+        return CalculateRangeFactorTriangle(textStart, textEnd, rangeStart, rangeEnd, easeHigh,
+                                            easeLow);
+      });
+      break;
+    case TextRangeSelectorShape::Round:  // 圆形
+      calculateFactorsByShape(factors, [this](float textStart, float textEnd) {
+        return CalculateRangeFactorRound(textStart, textEnd, rangeStart, rangeEnd);
+      });
+      break;
+    case TextRangeSelectorShape::Smooth:  // 平滑
+      calculateFactorsByShape(factors, [this](float textStart, float textEnd) {
+        return CalculateRangeFactorSmooth(textStart, textEnd, rangeStart, rangeEnd);
+      });
+      break;
+    default:  // TextRangeSelectorShape::Square  // 正方形
+      calculateFactorsByShape(factors, [this](float textStart, float textEnd) {
+        return CalculateFactorSquare(textStart, textEnd, rangeStart, rangeEnd);
+      });
+      break;
+  }
+}
 }  // namespace pag
\ No newline at end of file
@@ -28,23 +28,32 @@ class TextSelectorRenderer {
       const std::vector<TextSelectorRenderer*>& selectorRenderers, size_t index,
       bool* pBiasFlag = nullptr);
 
+  // 一次性计算所有字符的范围因子，结果与逐个调用 CalculateFactorFromSelectors() 一致
+  static void CalculateFactorsFromSelectors(
+      const std::vector<TextSelectorRenderer*>& selectorRenderers, size_t textCount,
+      std::vector<float>* factors);
+
   TextSelectorRenderer(size_t textCount, Frame frame) : textCount(textCount), frame(frame) {
   }
   virtual ~TextSelectorRenderer() = default;
 
   // 叠加选择器
   float overlayFactor(float oldFactor, float factor, bool isFirstSelector);
+  // 批量叠加选择器，totalFactors 和 factors 的长度均为 textCount
+  void overlayFactors(float* totalFactors, const float* factors, bool isFirstSelector) const;
 
  protected:
   size_t textCount = 0;
   Frame frame = 0;
   Enum mode = TextSelectorMode::Intersect;  // 模式
-  std::vector<int> randomIndexs;
+  std::shared_ptr<const std::vector<int>> randomIndexs = nullptr;
 
-  // 生成随机序号
+  // 生成随机序号，相同种子和字符数的结果会被缓存复用
   void calculateRandomIndexs(uint16_t seed);
   // 计算某个字符的范围因子
   virtual float calculateFactorByIndex(size_t index, bool* pBiasFlag) = 0;
+  // 计算所有字符的范围因子，factors 的长度为 textCount
+  virtual void calculateFactors(float* factors);
 };
 
 class WigglySelectorRenderer : public TextSelectorRenderer {
@@ -55,6 +64,7 @@ class WigglySelectorRenderer : public TextSelectorRenderer {
  private:
   // 计算某个字符的范围因子
   float calculateFactorByIndex(size_t index, bool* pBiasFlag) override;
+  void calculateFactors(float* factors) override;
 
   // 摆动选择器参数：模式(在父类里)、最大量、最小量、摆动/秒、关联、时间相位、空间相位
   float maxAmount = 1.0f;  // 最大量
@@ -74,7 +84,10 @@ class RangeSelectorRenderer : public TextSelectorRenderer {
  private:
   // 计算某个字符的范围因子
   float calculateFactorByIndex(size_t index, bool* pBiasFlag) override;
+  void calculateFactors(float* factors) override;
   void calculateBiasFlag(bool* pBiasFlag);
+  template <typename ShapeFunc>
+  void calculateFactorsByShape(float* factors, ShapeFunc shapeFunc) const;
 
   float rangeStart = 0.0f;
   float rangeEnd = 1.0f;  // AE默认范围是(0%-100%)
@@ -17,6 +17,8 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "BitmapSequenceReader.h"
+#include <algorithm>
+#include "codec/utils/WebpDecoder.h"
 #include "tgfx/core/ImageCodec.h"
 #include "tgfx/core/Pixmap.h"
 #include "tgfx/utils/Buffer.h"
@@ -66,30 +68,38 @@ std::shared_ptr<tgfx::ImageBuffer> BitmapSequenceReader::onMakeBuffer(Frame targ
     pixmap.reset(info, const_cast<void*>(pixels->data()));
   }
   auto startFrame = findStartFrame(targetFrame);
-  auto& bitmapFrames = static_cast<BitmapSequence*>(sequence)->frames;
-  for (Frame frame = startFrame; frame <= targetFrame; frame++) {
-    auto bitmapFrame = bitmapFrames[frame];
-    auto firstRead = true;
-    for (auto bitmapRect : bitmapFrame->bitmaps) {
-      auto imageBytes = tgfx::Data::MakeWithoutCopy(bitmapRect->fileBytes->data(),
-                                                    bitmapRect->fileBytes->length());
-      auto codec = tgfx::ImageCodec::MakeFrom(imageBytes);
-      // The returned image could be nullptr if the frame is an empty frame.
-      if (codec != nullptr) {
-        if (firstRead && bitmapFrame->isKeyframe &&
-            !(codec->width() == pixmap.width() && codec->height() == pixmap.height())) {
-          // clear the whole screen if the size of the key frame is smaller than the screen.
-          pixmap.clear();
-        }
-        auto offset = pixmap.rowBytes() * bitmapRect->y + bitmapRect->x * 4;
-        auto result = codec->readPixels(
-            pixmap.info(), reinterpret_cast<uint8_t*>(pixmap.writablePixels()) + offset);
-        if (!result) {
-          tgfx::HardwareBufferUnlock(hardWareBuffer);
-          return nullptr;
-        }
-        firstRead = false;
+  auto bitmaps = collectVisibleBitmaps(startFrame, targetFrame);
+  auto startBitmapFrame = static_cast<BitmapSequence*>(sequence)->frames[startFrame];
+  if (startBitmapFrame->isKeyframe) {
+    for (auto bitmapRect : startBitmapFrame->bitmaps) {
+      int width = 0;
+      int height = 0;
+      // The empty bitmaps are skipped when reading pixels.
+      if (!WebPGetInfo(bitmapRect->fileBytes->data(), bitmapRect->fileBytes->length(), &width,
+                       &height)) {
+        continue;
+      }
+      if (width != pixmap.width() || height != pixmap.height()) {
+        // clear the whole screen if the size of the key frame is smaller than the screen.
+        pixmap.clear();
       }
+      break;
+    }
+  }
+  for (auto bitmapRect : bitmaps) {
+    auto imageBytes = tgfx::Data::MakeWithoutCopy(bitmapRect->fileBytes->data(),
+                                                  bitmapRect->fileBytes->length());
+    auto codec = tgfx::ImageCodec::MakeFrom(imageBytes);
+    // The returned image could be nullptr if the frame is an empty frame.
+    if (codec == nullptr) {
+      continue;
+    }
+    auto offset = pixmap.rowBytes() * bitmapRect->y + bitmapRect->x * 4;
+    auto result = codec->readPixels(pixmap.info(),
+                                    reinterpret_cast<uint8_t*>(pixmap.writablePixels()) + offset);
+    if (!result) {
+      tgfx::HardwareBufferUnlock(hardWareBuffer);
+      return nullptr;
     }
   }
   if (hardWareBuffer) {
@@ -106,6 +116,41 @@ void BitmapSequenceReader::onReportPerformance(Performance* performance, int64_t
   performance->imageDecodingTime += decodingTime;
 }
 
+std::vector<BitmapRect*> BitmapSequenceReader::collectVisibleBitmaps(Frame startFrame,
+                                                                     Frame targetFrame) {
+  auto& bitmapFrames = static_cast<BitmapSequence*>(sequence)->frames;
+  if (startFrame == targetFrame) {
+    return bitmapFrames[targetFrame]->bitmaps;
+  }
+  // The bitmaps overwrite all pixels within their bounds when being read, so a bitmap can be
+  // skipped if it is covered entirely by a bitmap read after it. Only the WebP headers are parsed
+  // here, which is much cheaper than decoding the bitmaps that would be overwritten while seeking.
+  std::vector<BitmapRect*> bitmaps = {};
+  std::vector<tgfx::Rect> laterBounds = {};
+  for (Frame frame = targetFrame; frame >= startFrame; frame--) {
+    auto& frameBitmaps = bitmapFrames[frame]->bitmaps;
+    for (auto iter = frameBitmaps.rbegin(); iter != frameBitmaps.rend(); ++iter) {
+      auto bitmapRect = *iter;
+      int width = 0;
+      int height = 0;
+      if (!WebPGetInfo(bitmapRect->fileBytes->data(), bitmapRect->fileBytes->length(), &width,
+                       &height)) {
+        bitmaps.push_back(bitmapRect);
+        continue;
+      }
+      auto bounds = tgfx::Rect::MakeXYWH(bitmapRect->x, bitmapRect->y, width, height);
+      auto covered = std::any_of(laterBounds.begin(), laterBounds.end(),
+                                 [&](const tgfx::Rect& rect) { return rect.contains(bounds); });
+      if (!covered) {
+        bitmaps.push_back(bitmapRect);
+        laterBounds.push_back(bounds);
+      }
+    }
+  }
+  std::reverse(bitmaps.begin(), bitmaps.end());
+  return bitmaps;
+}
+
 Frame BitmapSequenceReader::findStartFrame(Frame targetFrame) {
   Frame startFrame = 0;
   auto& bitmapFrames = static_cast<BitmapSequence*>(sequence)->frames;
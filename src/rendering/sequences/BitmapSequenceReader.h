@@ -45,6 +45,12 @@ class BitmapSequenceReader : public SequenceReader {
 
   Frame findStartFrame(Frame targetFrame);
 
+  /**
+   * Returns the bitmaps to read from the startFrame to the targetFrame in order, skipping those
+   * overwritten entirely by the following ones.
+   */
+  std::vector<BitmapRect*> collectVisibleBitmaps(Frame startFrame, Frame targetFrame);
+
   std::mutex locker = {};
   // Keep a reference to the File in case the Sequence object is released while we are using it.
   std::shared_ptr<File> file = nullptr;
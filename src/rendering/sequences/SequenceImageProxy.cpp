@@ -42,6 +42,14 @@ std::shared_ptr<tgfx::Image> SequenceImageProxy::getImage(RenderCache* cache) co
   return cache->getSequenceImage(sequence, targetFrame);
 }
 
+std::shared_ptr<AlphaMask> SequenceImageProxy::getAlphaMask(RenderCache* cache) const {
+  if (sequence->staticContent()) {
+    // The hit tests of static sequences are answered by their snapshots.
+    return nullptr;
+  }
+  return cache->getSequenceAlphaMask(sequence, targetFrame);
+}
+
 std::shared_ptr<tgfx::Image> SequenceImageProxy::makeImage(RenderCache* cache) const {
   if (!sequence->staticContent()) {
     return nullptr;
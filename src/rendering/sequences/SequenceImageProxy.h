@@ -43,6 +43,8 @@ class SequenceImageProxy : public ImageProxy {
 
   std::shared_ptr<tgfx::Image> getImage(RenderCache* cache) const override;
 
+  std::shared_ptr<AlphaMask> getAlphaMask(RenderCache* cache) const override;
+
  protected:
   std::shared_ptr<tgfx::Image> makeImage(RenderCache* cache) const override;
 
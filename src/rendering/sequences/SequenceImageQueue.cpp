@@ -17,10 +17,16 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SequenceImageQueue.h"
+#include <algorithm>
 
 namespace pag {
+// Besides the decoded frames in the queue, one buffer is held by the current image, and another
+// one may still be referenced by the previous image until the next flush.
+static constexpr size_t EXTRA_POOL_BUFFERS = 2;
+
 std::unique_ptr<SequenceImageQueue> SequenceImageQueue::MakeFrom(
-    std::shared_ptr<SequenceInfo> sequence, PAGLayer* pagLayer, bool useDiskCache) {
+    std::shared_ptr<SequenceInfo> sequence, PAGLayer* pagLayer, bool useDiskCache,
+    int decodeAheadFrames) {
   if (sequence == nullptr || pagLayer == nullptr || sequence->staticContent()) {
     return nullptr;
   }
@@ -28,27 +34,43 @@ std::unique_ptr<SequenceImageQueue> SequenceImageQueue::MakeFrom(
   if (reader == nullptr) {
     return nullptr;
   }
+  size_t aheadFrames = 1;
+  if (decodeAheadFrames > 1 &&
+      reader->enableBufferPool(static_cast<size_t>(decodeAheadFrames) + EXTRA_POOL_BUFFERS)) {
+    aheadFrames = static_cast<size_t>(decodeAheadFrames);
+  }
   auto firstFrame = sequence->firstVisibleFrame(pagLayer->getLayer());
-  return std::unique_ptr<SequenceImageQueue>(
-      new SequenceImageQueue(sequence, std::move(reader), firstFrame, useDiskCache));
+  return std::unique_ptr<SequenceImageQueue>(new SequenceImageQueue(
+      sequence, std::move(reader), firstFrame, useDiskCache, aheadFrames));
 }
 
 SequenceImageQueue::SequenceImageQueue(std::shared_ptr<SequenceInfo> sequence,
                                        std::shared_ptr<SequenceReader> reader, Frame firstFrame,
-                                       bool useDiskCache)
+                                       bool useDiskCache, size_t decodeAheadFrames)
     : sequence(sequence), reader(std::move(reader)), firstFrame(firstFrame),
-      totalFrames(sequence->duration()), useDiskCache(useDiskCache) {
+      totalFrames(sequence->duration()), useDiskCache(useDiskCache),
+      decodeAheadFrames(decodeAheadFrames) {
 }
 
-void SequenceImageQueue::prepareNextImage() {
-  auto nextFrame = currentFrame + 1;
-  if (nextFrame >= totalFrames) {
-    nextFrame = firstFrame;
+SequenceImageQueue::~SequenceImageQueue() {
+  {
+    std::lock_guard<std::mutex> autoLock(bufferLocker);
+    decodeStopped = true;
+  }
+  if (decodeTask != nullptr) {
+    decodeTask->wait();
   }
-  prepare(nextFrame);
+}
+
+void SequenceImageQueue::prepareNextImage() {
+  prepare(nextFrameOf(currentFrame));
 }
 
 void SequenceImageQueue::prepare(Frame targetFrame) {
+  if (decodeAheadFrames > 1) {
+    prepareAhead(targetFrame);
+    return;
+  }
   if (preparedImage != nullptr || targetFrame < 0 || targetFrame >= totalFrames) {
     return;
   }
@@ -61,6 +83,9 @@ std::shared_ptr<tgfx::Image> SequenceImageQueue::getImage(Frame targetFrame) {
   if (targetFrame == currentFrame) {
     return currentImage;
   }
+  if (decodeAheadFrames > 1) {
+    return getImageAhead(targetFrame);
+  }
   if (targetFrame == preparedFrame) {
     currentImage = preparedImage;
     preparedImage = nullptr;
@@ -78,7 +103,133 @@ std::shared_ptr<tgfx::Image> SequenceImageQueue::getImage(Frame targetFrame) {
   return currentImage;
 }
 
+std::shared_ptr<AlphaMask> SequenceImageQueue::getAlphaMask(tgfx::Context* context,
+                                                            Frame targetFrame) {
+  auto image = getImage(targetFrame);
+  if (image == nullptr) {
+    return nullptr;
+  }
+  if (alphaMask == nullptr || maskFrame != currentFrame) {
+    alphaMask = AlphaMask::Make(context, std::move(image));
+    maskFrame = currentFrame;
+  }
+  return alphaMask;
+}
+
 void SequenceImageQueue::reportPerformance(Performance* performance) {
   reader->reportPerformance(performance);
 }
+
+Frame SequenceImageQueue::nextFrameOf(Frame frame) const {
+  auto nextFrame = frame + 1;
+  if (nextFrame >= totalFrames) {
+    nextFrame = firstFrame;
+  }
+  return nextFrame;
+}
+
+void SequenceImageQueue::prepareAhead(Frame targetFrame) {
+  if (targetFrame < 0 || targetFrame >= totalFrames) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> autoLock(bufferLocker);
+    auto queued = targetFrame == currentFrame || targetFrame == nextDecodeFrame ||
+                  targetFrame == decodingFrame;
+    for (auto& item : aheadBuffers) {
+      if (item.first == targetFrame) {
+        queued = true;
+        break;
+      }
+    }
+    if (!queued) {
+      // Seeking happens, drop all frames decoded ahead and restart from the target frame.
+      decodeGeneration++;
+      aheadBuffers.clear();
+      nextDecodeFrame = targetFrame;
+    }
+  }
+  scheduleDecodeAhead();
+}
+
+void SequenceImageQueue::scheduleDecodeAhead() {
+  std::lock_guard<std::mutex> autoLock(bufferLocker);
+  decodeAllowed = true;
+  if (decodeScheduled || decodeStopped) {
+    return;
+  }
+  decodeScheduled = true;
+  decodeTask = tgfx::Task::Run([this]() { decodeAhead(); });
+}
+
+void SequenceImageQueue::decodeAhead() {
+  std::unique_lock<std::mutex> autoLock(bufferLocker);
+  while (!decodeStopped && decodeAllowed && nextDecodeFrame >= 0) {
+    // Image buffers of readers without an active buffer pool share the same backing memory, so we
+    // can only keep one of them ahead.
+    auto maxBuffers = reader->bufferPoolActive() ? decodeAheadFrames : static_cast<size_t>(1);
+    maxBuffers = std::min(maxBuffers, static_cast<size_t>(totalFrames));
+    if (aheadBuffers.size() >= maxBuffers) {
+      break;
+    }
+    auto targetFrame = nextDecodeFrame;
+    auto generation = decodeGeneration;
+    decodingFrame = targetFrame;
+    autoLock.unlock();
+    auto buffer = reader->readBuffer(targetFrame);
+    autoLock.lock();
+    decodingFrame = -1;
+    condition.notify_all();
+    if (generation != decodeGeneration) {
+      continue;
+    }
+    if (buffer == nullptr) {
+      break;
+    }
+    aheadBuffers.emplace_back(targetFrame, std::move(buffer));
+    nextDecodeFrame = nextFrameOf(targetFrame);
+  }
+  decodeScheduled = false;
+}
+
+std::shared_ptr<tgfx::ImageBuffer> SequenceImageQueue::takeAheadBuffer(Frame targetFrame) {
+  std::unique_lock<std::mutex> autoLock(bufferLocker);
+  if (!reader->bufferPoolActive()) {
+    // The next decoding would overwrite the buffer of the returned frame before it is drawn.
+    decodeAllowed = false;
+  }
+  condition.wait(autoLock, [&] { return decodingFrame != targetFrame; });
+  while (!aheadBuffers.empty()) {
+    auto item = aheadBuffers.front();
+    aheadBuffers.pop_front();
+    if (item.first == targetFrame) {
+      return item.second;
+    }
+  }
+  // Seeking happens, stop decoding ahead until the next prepare() call, and wait for the pending
+  // decoding to finish so that it can not take over the reader after we read the target frame.
+  decodeGeneration++;
+  decodeAllowed = false;
+  condition.wait(autoLock, [&] { return decodingFrame < 0; });
+  nextDecodeFrame = nextFrameOf(targetFrame);
+  return nullptr;
+}
+
+std::shared_ptr<tgfx::Image> SequenceImageQueue::getImageAhead(Frame targetFrame) {
+  auto buffer = takeAheadBuffer(targetFrame);
+  if (buffer == nullptr) {
+    buffer = reader->readBuffer(targetFrame);
+    if (buffer == nullptr) {
+      return nullptr;
+    }
+  }
+  auto image = sequence->makeFrameImage(std::move(buffer), useDiskCache);
+  if (image == nullptr) {
+    return nullptr;
+  }
+  currentImage = image->makeDecoded();
+  currentFrame = targetFrame;
+  preparedFrame = nextFrameOf(targetFrame);
+  return currentImage;
+}
 }  // namespace pag
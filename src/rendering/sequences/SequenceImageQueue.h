@@ -18,16 +18,30 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include "SequenceInfo.h"
 #include "SequenceReader.h"
 #include "pag/file.h"
 #include "pag/pag.h"
+#include "rendering/graphics/AlphaMask.h"
+#include "tgfx/utils/Task.h"
 
 namespace pag {
 class SequenceImageQueue {
  public:
+  /**
+   * Creates a SequenceImageQueue for the specified sequence. If decodeAheadFrames is greater than
+   * 1 and the reader of the sequence can keep multiple decoded frames alive, the queue decodes up
+   * to decodeAheadFrames frames ahead of the current frame on a background task. Otherwise, it
+   * only prepares the next frame.
+   */
   static std::unique_ptr<SequenceImageQueue> MakeFrom(std::shared_ptr<SequenceInfo> sequence,
-                                                      PAGLayer* pagLayer, bool useDiskCache);
+                                                      PAGLayer* pagLayer, bool useDiskCache,
+                                                      int decodeAheadFrames = 1);
+
+  ~SequenceImageQueue();
 
   /**
    * Prepares the image of the next frame.
@@ -44,6 +58,12 @@ class SequenceImageQueue {
    */
   std::shared_ptr<tgfx::Image> getImage(Frame targetFrame);
 
+  /**
+   * Returns the AlphaMask of the specified frame, which is built from the image of the frame and
+   * kept until a mask of another frame is requested.
+   */
+  std::shared_ptr<AlphaMask> getAlphaMask(tgfx::Context* context, Frame targetFrame);
+
   /**
    * Reports the decoding performance data.
    */
@@ -58,10 +78,30 @@ class SequenceImageQueue {
   Frame preparedFrame = -1;
   std::shared_ptr<tgfx::Image> currentImage = nullptr;
   std::shared_ptr<tgfx::Image> preparedImage = nullptr;
+  std::shared_ptr<AlphaMask> alphaMask = nullptr;
+  Frame maskFrame = -1;
   bool useDiskCache = false;
+  size_t decodeAheadFrames = 1;
+  std::mutex bufferLocker = {};
+  std::condition_variable condition = {};
+  std::deque<std::pair<Frame, std::shared_ptr<tgfx::ImageBuffer>>> aheadBuffers = {};
+  Frame nextDecodeFrame = -1;
+  Frame decodingFrame = -1;
+  uint32_t decodeGeneration = 0;
+  bool decodeAllowed = false;
+  bool decodeScheduled = false;
+  bool decodeStopped = false;
+  std::shared_ptr<tgfx::Task> decodeTask = nullptr;
 
   SequenceImageQueue(std::shared_ptr<SequenceInfo> sequence, std::shared_ptr<SequenceReader> reader,
-                     Frame firstFrame, bool useDiskCache);
+                     Frame firstFrame, bool useDiskCache, size_t decodeAheadFrames);
+
+  Frame nextFrameOf(Frame frame) const;
+  void prepareAhead(Frame targetFrame);
+  void scheduleDecodeAhead();
+  void decodeAhead();
+  std::shared_ptr<tgfx::ImageBuffer> takeAheadBuffer(Frame targetFrame);
+  std::shared_ptr<tgfx::Image> getImageAhead(Frame targetFrame);
 
   friend class RenderCache;
 };
@@ -46,6 +46,23 @@ class SequenceReader {
 
   void reportPerformance(Performance* performance);
 
+  /**
+   * Asks the reader to return image buffers that stay valid while the following frames are
+   * decoded, which keeps at most maxBuffers released buffers for reusing. Returns false if the
+   * reader does not support it.
+   */
+  virtual bool enableBufferPool(size_t) {
+    return false;
+  }
+
+  /**
+   * Returns true if the image buffer returned by the last readBuffer() call stays valid while the
+   * following frames are decoded.
+   */
+  virtual bool bufferPoolActive() const {
+    return false;
+  }
+
  protected:
   /**
    * Return the decoded ImageBuffer of the specified frame.
@@ -19,6 +19,7 @@
 #include "VideoReader.h"
 #include "base/utils/TimeUtil.h"
 #include "platform/Platform.h"
+#include "rendering/video/VideoDecoderPool.h"
 #include "tgfx/utils/Clock.h"
 
 namespace pag {
@@ -39,7 +40,7 @@ VideoReader::VideoReader(std::unique_ptr<VideoDemuxer> videoDemuxer)
 }
 
 VideoReader::~VideoReader() {
-  destroyVideoDecoder();
+  destroyVideoDecoder(true);
   delete demuxer;
 }
 
@@ -63,7 +64,7 @@ std::shared_ptr<tgfx::ImageBuffer> VideoReader::onMakeBuffer(Frame targetFrame)
     success = decodeFrame(sampleTime);
     if (!success) {
       // fallback to software decoder.
-      destroyVideoDecoder();
+      destroyVideoDecoder(false);
       factoryIndex++;
       if (checkVideoDecoder()) {
         success = decodeFrame(sampleTime);
@@ -83,6 +84,19 @@ std::shared_ptr<tgfx::ImageBuffer> VideoReader::onMakeBuffer(Frame targetFrame)
   return lastBuffer;
 }
 
+bool VideoReader::enableBufferPool(size_t maxBuffers) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto videoFormat = demuxer->getFormat();
+  framePool = VideoFramePool::Make(videoFormat.width, videoFormat.height, maxBuffers);
+  if (framePool == nullptr) {
+    return false;
+  }
+  if (videoDecoder != nullptr) {
+    _bufferPoolActive = videoDecoder->setFramePool(framePool);
+  }
+  return true;
+}
+
 void VideoReader::onReportPerformance(Performance* performance, int64_t decodingTime) {
   if (videoDecoder == nullptr) {
     return;
@@ -161,17 +175,25 @@ bool VideoReader::checkVideoDecoder() {
   }
   videoDecoder = makeVideoDecoder().release();
   if (videoDecoder) {
+    _bufferPoolActive = framePool != nullptr && videoDecoder->setFramePool(framePool);
     return true;
   }
   return false;
 }
 
-void VideoReader::destroyVideoDecoder() {
+void VideoReader::destroyVideoDecoder(bool reusable) {
   if (videoDecoder == nullptr) {
     return;
   }
-  delete videoDecoder;
+  if (reusable) {
+    VideoDecoderPool::GetInstance()->recycle(videoFactory, demuxer->getFormat(),
+                                             std::unique_ptr<VideoDecoder>(videoDecoder));
+  } else {
+    delete videoDecoder;
+  }
   videoDecoder = nullptr;
+  videoFactory = nullptr;
+  _bufferPoolActive = false;
   lastBuffer = nullptr;
   currentRenderedTime = INT64_MIN;
   resetParams();
@@ -193,9 +215,20 @@ std::unique_ptr<VideoDecoder> VideoReader::makeVideoDecoder() {
       factoryIndex++;
       continue;
     }
+    auto decoder = VideoDecoderPool::GetInstance()->obtain(factory, demuxer->getFormat());
+    if (decoder != nullptr) {
+      videoFactory = factory;
+      return decoder;
+    }
     tgfx::Clock clock = {};
-    auto decoder = factory->createDecoder(demuxer->getFormat());
+    decoder = factory->createDecoder(demuxer->getFormat());
+    if (decoder == nullptr && factory->isHardwareBacked() &&
+        VideoDecoderPool::GetInstance()->purgeHardwareDecoders()) {
+      // The idle hardware decoders in the pool may have taken up the hardware decoder quota.
+      decoder = factory->createDecoder(demuxer->getFormat());
+    }
     if (decoder != nullptr) {
+      videoFactory = factory;
       if (decoder->isHardwareBacked()) {
         hardDecodingInitialTime = clock.elapsedTime();
       } else {
@@ -38,6 +38,12 @@ class VideoReader : public SequenceReader {
     return demuxer->getFormat().height;
   }
 
+  bool enableBufferPool(size_t maxBuffers) override;
+
+  bool bufferPoolActive() const override {
+    return _bufferPoolActive;
+  }
+
  protected:
   std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(Frame targetFrame) override;
 
@@ -49,6 +55,7 @@ class VideoReader : public SequenceReader {
   float frameRate = 0.0;
   int factoryIndex = 0;
   bool preferSoftware = false;
+  const VideoDecoderFactory* videoFactory = nullptr;
   VideoDecoder* videoDecoder = nullptr;
   VideoSample videoSample = {};
   std::shared_ptr<tgfx::ImageBuffer> lastBuffer = nullptr;
@@ -58,8 +65,10 @@ class VideoReader : public SequenceReader {
   int64_t currentRenderedTime = INT64_MIN;
   std::atomic_int64_t hardDecodingInitialTime = 0;
   std::atomic_int64_t softDecodingInitialTime = 0;
+  std::shared_ptr<VideoFramePool> framePool = nullptr;
+  std::atomic_bool _bufferPoolActive = false;
 
-  void destroyVideoDecoder();
+  void destroyVideoDecoder(bool reusable);
 
   bool checkVideoDecoder();
 
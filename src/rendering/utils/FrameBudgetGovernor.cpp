@@ -0,0 +1,75 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FrameBudgetGovernor.h"
+#include "pag/types.h"
+
+namespace pag {
+// The number of consecutive frames over the budget before the quality is lowered.
+static constexpr int DegradeFrameCount = 3;
+// The number of consecutive frames within the headroom before the quality is restored.
+static constexpr int RestoreFrameCount = 30;
+// A frame is considered to have headroom if it costs less than this ratio of the budget.
+static constexpr float HeadroomRatio = 0.6f;
+
+void FrameBudgetGovernor::setFrameBudget(int64_t value) {
+  budget = value > 0 ? value : 0;
+  setLevel(PAGQualityLevel::Full);
+}
+
+bool FrameBudgetGovernor::recordFrame(int64_t frameTime) {
+  if (budget <= 0) {
+    return false;
+  }
+  if (frameTime > budget) {
+    underBudgetFrames = 0;
+    if (++overBudgetFrames >= DegradeFrameCount && level < PAGQualityLevel::LowFrameRate) {
+      setLevel(level + 1);
+      return true;
+    }
+  } else if (static_cast<float>(frameTime) < static_cast<float>(budget) * HeadroomRatio) {
+    overBudgetFrames = 0;
+    if (++underBudgetFrames >= RestoreFrameCount && level > PAGQualityLevel::Full) {
+      setLevel(level - 1);
+      return true;
+    }
+  } else {
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+  }
+  return false;
+}
+
+float FrameBudgetGovernor::cacheScaleFactor() const {
+  return level >= PAGQualityLevel::LowCacheScale ? 0.5f : 1.0f;
+}
+
+bool FrameBudgetGovernor::expensiveFiltersEnabled() const {
+  return level < PAGQualityLevel::NoExpensiveFilters;
+}
+
+float FrameBudgetGovernor::frameRateFactor() const {
+  return level >= PAGQualityLevel::LowFrameRate ? 0.5f : 1.0f;
+}
+
+void FrameBudgetGovernor::setLevel(int value) {
+  level = value;
+  overBudgetFrames = 0;
+  underBudgetFrames = 0;
+}
+}  // namespace pag
@@ -0,0 +1,80 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+namespace pag {
+/**
+ * Watches the time cost of each frame against a budget and chooses a PAGQualityLevel for the
+ * upcoming frames. The level is raised after several consecutive frames over the budget, and
+ * lowered only after a long run of frames well within the budget, so that it does not oscillate.
+ */
+class FrameBudgetGovernor {
+ public:
+  /**
+   * Returns the time budget of a frame in microseconds. 0 means the governor is disabled.
+   */
+  int64_t frameBudget() const {
+    return budget;
+  }
+
+  /**
+   * Sets the time budget of a frame in microseconds, which also resets the quality level to
+   * PAGQualityLevel::Full. Values less than or equal to 0 disable the governor.
+   */
+  void setFrameBudget(int64_t value);
+
+  /**
+   * Returns the current quality level, ranges from PAGQualityLevel::Full to
+   * PAGQualityLevel::LowFrameRate.
+   */
+  int qualityLevel() const {
+    return level;
+  }
+
+  /**
+   * Records the time cost of a frame in microseconds. Returns true if the quality level changed.
+   */
+  bool recordFrame(int64_t frameTime);
+
+  /**
+   * Returns the factor to apply to the cacheScale of the player at the current quality level.
+   */
+  float cacheScaleFactor() const;
+
+  /**
+   * Returns false if expensive filters should be skipped at the current quality level.
+   */
+  bool expensiveFiltersEnabled() const;
+
+  /**
+   * Returns the factor to apply to the maxFrameRate of the player at the current quality level.
+   */
+  float frameRateFactor() const;
+
+ private:
+  int64_t budget = 0;
+  int level = 0;
+  int overBudgetFrames = 0;
+  int underBudgetFrames = 0;
+
+  void setLevel(int value);
+};
+}  // namespace pag
@@ -0,0 +1,58 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FrameSnapshot.h"
+
+namespace pag {
+void FrameSnapshotHolder::beginRendering(std::shared_ptr<const FrameSnapshot> newSnapshot) {
+  // The snapshot must be visible before the rendering flag, readers check them in reverse order.
+  std::atomic_store(&snapshot, std::move(newSnapshot));
+  rendering = true;
+}
+
+void FrameSnapshotHolder::endRendering() {
+  rendering = false;
+}
+
+std::shared_ptr<const FrameSnapshot> FrameSnapshotHolder::renderingSnapshot() const {
+  if (!rendering) {
+    return nullptr;
+  }
+  return std::atomic_load(&snapshot);
+}
+
+SnapshotReadGuard::SnapshotReadGuard(std::shared_ptr<std::mutex> rootLocker,
+                                     const FrameSnapshotHolder* holder) {
+  if (rootLocker->try_lock()) {
+    locker = std::move(rootLocker);
+    return;
+  }
+  _snapshot = holder ? holder->renderingSnapshot() : nullptr;
+  if (_snapshot == nullptr) {
+    // The rootLocker is held by a short operation other than rendering, just wait for it.
+    rootLocker->lock();
+    locker = std::move(rootLocker);
+  }
+}
+
+SnapshotReadGuard::~SnapshotReadGuard() {
+  if (locker) {
+    locker->unlock();
+  }
+}
+}  // namespace pag
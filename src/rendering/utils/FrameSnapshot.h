@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "pag/types.h"
+
+namespace pag {
+/**
+ * An immutable copy of the player states evaluated at the beginning of a frame. It is published
+ * while the render thread is flushing, so that trivial queries from other threads can be answered
+ * without waiting for the rootLocker. It only covers the scalar getters of PAGPlayer. Geometry
+ * queries, such as getBounds() and hitTestPoint(), need the whole layer tree and still lock the
+ * rootLocker.
+ */
+struct FrameSnapshot {
+  int64_t duration = 0;
+  double progress = 0;
+  Frame currentFrame = 0;
+  Matrix matrix = Matrix::I();
+  int scaleMode = PAGScaleMode::LetterBox;
+  float maxFrameRate = 60;
+  bool autoClear = true;
+  int64_t renderingTime = 0;
+  int64_t imageDecodingTime = 0;
+  int64_t presentingTime = 0;
+  int64_t graphicsMemory = 0;
+};
+
+class FrameSnapshotHolder {
+ public:
+  /**
+   * Publishes the snapshot of the frame being rendered. Must be called with the rootLocker held.
+   */
+  void beginRendering(std::shared_ptr<const FrameSnapshot> snapshot);
+
+  /**
+   * Marks the end of the rendering. Must be called with the rootLocker held.
+   */
+  void endRendering();
+
+  /**
+   * Returns the published snapshot if a rendering is in progress, otherwise returns nullptr.
+   */
+  std::shared_ptr<const FrameSnapshot> renderingSnapshot() const;
+
+ private:
+  std::shared_ptr<const FrameSnapshot> snapshot = nullptr;
+  std::atomic_bool rendering = {false};
+};
+
+/**
+ * Locks the rootLocker for a query, unless it is held by a rendering in progress. In that case, the
+ * snapshot of the frame being rendered is returned by snapshot() and the rootLocker is not locked.
+ */
+class SnapshotReadGuard {
+ public:
+  SnapshotReadGuard(std::shared_ptr<std::mutex> locker, const FrameSnapshotHolder* holder);
+
+  ~SnapshotReadGuard();
+
+  const FrameSnapshot* snapshot() const {
+    return _snapshot.get();
+  }
+
+ private:
+  std::shared_ptr<std::mutex> locker = nullptr;
+  std::shared_ptr<const FrameSnapshot> _snapshot = nullptr;
+};
+
+/**
+ * Publishes a snapshot for the lifetime of the scope, the rootLocker must be held by the caller.
+ */
+class RenderingScope {
+ public:
+  RenderingScope(FrameSnapshotHolder* holder, std::shared_ptr<const FrameSnapshot> snapshot)
+      : holder(holder) {
+    holder->beginRendering(std::move(snapshot));
+  }
+
+  RenderingScope(const RenderingScope&) = delete;
+
+  RenderingScope& operator=(const RenderingScope&) = delete;
+
+  ~RenderingScope() {
+    holder->endRendering();
+  }
+
+ private:
+  FrameSnapshotHolder* holder = nullptr;
+};
+}  // namespace pag
@@ -0,0 +1,146 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace pag {
+/**
+ * LRUCache keeps the most recently used values within a memory limit. It backs the caches shared by
+ * the shapes of all players, such as the PathMeasureCache. The entries are spread over a few shards
+ * by the hashes of their keys, and every shard has its own lock, so that the threads rendering
+ * different shapes rarely wait for each other.
+ *
+ * A cached value only pays off if its key shows up again in a later frame. Values computed from
+ * animated inputs are different in every frame, so the callers compute them directly and never
+ * add them, which would only evict the values that are still useful.
+ */
+template <typename Key, typename Value, typename Hasher = std::hash<Key>>
+class LRUCache {
+ public:
+  explicit LRUCache(size_t maxMemory) : maxMemory(maxMemory) {
+  }
+
+  /**
+   * Sets the max memory in bytes of all values. The least recently used values exceeding it are
+   * freed by the next call to add().
+   */
+  void setMaxMemory(size_t bytes) {
+    maxMemory = bytes;
+  }
+
+  /**
+   * Returns the memory in bytes of all cached values.
+   */
+  size_t memoryUsage() {
+    size_t usage = 0;
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> autoLock(shard.locker);
+      usage += shard.memoryUsage;
+    }
+    return usage;
+  }
+
+  /**
+   * Copies the value of the specified key to the result and marks it as the most recently used.
+   * Returns false if the key is not cached.
+   */
+  bool find(const Key& key, Value* result) {
+    auto hash = Hasher()(key);
+    auto& shard = shards[hash % ShardCount];
+    std::lock_guard<std::mutex> autoLock(shard.locker);
+    auto entry = shard.find(key, hash);
+    if (entry == shard.entries.end()) {
+      return false;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+    *result = entry->value;
+    return true;
+  }
+
+  /**
+   * Adds the value of the specified key, which takes the specified memory in bytes. The value is
+   * not cached if the key is already cached or the value takes more than one shard can hold.
+   */
+  void add(const Key& key, Value value, size_t memory) {
+    auto shardMemory = maxMemory / ShardCount;
+    if (memory > shardMemory) {
+      return;
+    }
+    auto hash = Hasher()(key);
+    auto& shard = shards[hash % ShardCount];
+    // The evicted values are freed after the locker is released.
+    std::list<Entry> evictedEntries = {};
+    std::lock_guard<std::mutex> autoLock(shard.locker);
+    if (shard.find(key, hash) != shard.entries.end()) {
+      return;
+    }
+    shard.entries.push_front({key, std::move(value), hash, memory});
+    shard.entryMap.emplace(hash, shard.entries.begin());
+    shard.memoryUsage += memory;
+    while (shard.memoryUsage > shardMemory) {
+      auto last = std::prev(shard.entries.end());
+      auto range = shard.entryMap.equal_range(last->hash);
+      for (auto iter = range.first; iter != range.second; iter++) {
+        if (iter->second == last) {
+          shard.entryMap.erase(iter);
+          break;
+        }
+      }
+      shard.memoryUsage -= last->memory;
+      evictedEntries.splice(evictedEntries.end(), shard.entries, last);
+    }
+  }
+
+ private:
+  static constexpr size_t ShardCount = 8;
+
+  struct Entry {
+    Key key;
+    Value value;
+    size_t hash;
+    size_t memory;
+  };
+
+  struct Shard {
+    std::mutex locker = {};
+    std::list<Entry> entries = {};
+    // Keyed by the hashes, so that a key is hashed only once for each lookup.
+    std::unordered_multimap<size_t, typename std::list<Entry>::iterator> entryMap = {};
+    size_t memoryUsage = 0;
+
+    typename std::list<Entry>::iterator find(const Key& key, size_t hash) {
+      auto range = entryMap.equal_range(hash);
+      for (auto iter = range.first; iter != range.second; iter++) {
+        if (iter->second->key == key) {
+          return iter->second;
+        }
+      }
+      return entries.end();
+    }
+  };
+
+  std::atomic<size_t> maxMemory = {0};
+  Shard shards[ShardCount] = {};
+};
+}  // namespace pag
@@ -310,9 +310,9 @@ void MemoryCalculator::CaculateResourcesMaxScaleAndTimeRanges(
                              resourcesTimeRangesMap);
 }
 
-int64_t CalculateGraphicsMemory(std::shared_ptr<File> file) {
+std::vector<int64_t> CalculateGraphicsMemoriesPerFrame(std::shared_ptr<File> file) {
   if (file == nullptr) {
-    return 0;
+    return {};
   }
   auto rootLayer = file->getRootLayer();
   std::unordered_map<void*, tgfx::Point> resourcesMaxScaleMap;
@@ -321,14 +321,19 @@ int64_t CalculateGraphicsMemory(std::shared_ptr<File> file) {
                                                            resourcesTimeRangesMap);
   std::vector<int64_t> memoriesPreFrame = MemoryCalculator::GetRootLayerGraphicsMemoriesPreFrame(
       rootLayer, resourcesMaxScaleMap, resourcesTimeRangesMap);
+  for (auto it = resourcesTimeRangesMap.begin(); it != resourcesTimeRangesMap.end(); it++) {
+    delete it->second;
+  }
+  return memoriesPreFrame;
+}
+
+int64_t CalculateGraphicsMemory(std::shared_ptr<File> file) {
+  auto memoriesPreFrame = CalculateGraphicsMemoriesPerFrame(std::move(file));
   int64_t maxGraphicsMemory = 0;
   for (std::vector<int64_t>::size_type i = 0; i < memoriesPreFrame.size(); i++) {
     maxGraphicsMemory =
         maxGraphicsMemory > memoriesPreFrame[i] ? maxGraphicsMemory : memoriesPreFrame[i];
   }
-  for (auto it = resourcesTimeRangesMap.begin(); it != resourcesTimeRangesMap.end(); it++) {
-    delete it->second;
-  }
   return maxGraphicsMemory;
 }
 }  // namespace pag
@@ -17,9 +17,17 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "PathHasher.h"
+#include <functional>
 
 namespace pag {
 size_t PathHasher::operator()(const tgfx::Path& path) const {
-  return path.countPoints();
+  // The number of points alone collides for every frame of an animated path, mix in the bounds.
+  auto bounds = path.getBounds();
+  std::hash<float> hasher = {};
+  auto hash = static_cast<size_t>(path.countPoints());
+  for (auto value : {bounds.left, bounds.top, bounds.right, bounds.bottom}) {
+    hash ^= hasher(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
 }
 }  // namespace pag
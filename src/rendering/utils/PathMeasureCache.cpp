@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PathMeasureCache.h"
+#include "rendering/caches/RenderCache.h"
+#include "rendering/utils/PathHasher.h"
+
+namespace pag {
+// Every lookup hashes and compares all points of the key path. Larger paths are measured directly,
+// so that one of them does not take the room of many small ones.
+static constexpr int MaxCachedPathPoints = 4096;
+// A point takes 8 bytes in the key path, and about two 12-byte segments in the length table since
+// curves are split into several segments.
+static constexpr size_t MeasuredPointMemory = 32;
+
+MeasuredPath::MeasuredPath(const tgfx::Path& path)
+    : pathMeasure(tgfx::PathMeasure::MakeFrom(path)) {
+  _length = pathMeasure->getLength();
+}
+
+bool MeasuredPath::getSegment(float startD, float stopD, tgfx::Path* result) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return pathMeasure->getSegment(startD, stopD, result);
+}
+
+std::shared_ptr<MeasuredPath> PathMeasureCache::Get(const tgfx::Path& path, bool animated) {
+  static auto& cache =
+      *RenderCache::MakeSharedCache<tgfx::Path, std::shared_ptr<MeasuredPath>, PathHasher>();
+  if (animated || path.countPoints() > MaxCachedPathPoints) {
+    return std::make_shared<MeasuredPath>(path);
+  }
+  std::shared_ptr<MeasuredPath> measuredPath = nullptr;
+  if (cache.find(path, &measuredPath)) {
+    return measuredPath;
+  }
+  // Measure the path outside the lock, other threads may measure the same path meanwhile.
+  measuredPath = std::make_shared<MeasuredPath>(path);
+  auto memory = static_cast<size_t>(path.countPoints()) * MeasuredPointMemory;
+  cache.add(path, measuredPath, memory);
+  return measuredPath;
+}
+}  // namespace pag
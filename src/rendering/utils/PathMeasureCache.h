@@ -0,0 +1,63 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include "tgfx/core/PathMeasure.h"
+
+namespace pag {
+/**
+ * MeasuredPath holds the contour length table of a path, which is built once and then shared
+ * across frames, so that extracting a segment only searches the cumulative lengths.
+ */
+class MeasuredPath {
+ public:
+  explicit MeasuredPath(const tgfx::Path& path);
+
+  float length() const {
+    return _length;
+  }
+
+  /**
+   * Appends the segment between startD and stopD to the result path. It is safe to call this
+   * method from multiple threads.
+   */
+  bool getSegment(float startD, float stopD, tgfx::Path* result);
+
+ private:
+  std::mutex locker = {};
+  std::unique_ptr<tgfx::PathMeasure> pathMeasure = nullptr;
+  float _length = 0;
+};
+
+/**
+ * PathMeasureCache keeps the length tables of the paths measured by trim paths, it is shared by all
+ * shapes of all players. A trim path animating its start and end over a static path measures the
+ * path only once.
+ */
+class PathMeasureCache {
+ public:
+  /**
+   * Returns the measured path equal to the specified path. Pass true for animated if the path
+   * changes between frames, then it is measured without touching the cache.
+   */
+  static std::shared_ptr<MeasuredPath> Get(const tgfx::Path& path, bool animated = false);
+};
+}  // namespace pag
@@ -22,31 +22,35 @@
 namespace pag {
 tgfx::Path ToPath(const PathData& pathData) {
   tgfx::Path path = {};
+  AddToPath(pathData, &path);
+  return path;
+}
+
+void AddToPath(const PathData& pathData, tgfx::Path* path) {
   auto& points = pathData.points;
   uint32_t index = 0;
   Point control1 = {}, control2 = {}, point = {};
   for (auto& verb : pathData.verbs) {
     switch (verb) {
       case PathDataVerb::Close:
-        path.close();
+        path->close();
         break;
       case PathDataVerb::MoveTo:
         point = points[index++];
-        path.moveTo(point.x, point.y);
+        path->moveTo(point.x, point.y);
         break;
       case PathDataVerb::LineTo:
         point = points[index++];
-        path.lineTo(point.x, point.y);
+        path->lineTo(point.x, point.y);
         break;
       case PathDataVerb::CurveTo:
         control1 = points[index++];
         control2 = points[index++];
         point = points[index++];
-        path.cubicTo(control1.x, control1.y, control2.x, control2.y, point.x, point.y);
+        path->cubicTo(control1.x, control1.y, control2.x, control2.y, point.x, point.y);
         break;
     }
   }
-  return path;
 }
 
 tgfx::PathOp ToPathOp(Enum maskMode) {
@@ -24,6 +24,7 @@
 namespace pag {
 
 tgfx::Path ToPath(const PathData& pathData);
+void AddToPath(const PathData& pathData, tgfx::Path* path);
 tgfx::PathOp ToPathOp(Enum maskMode);
 void ExpandPath(tgfx::Path* path, float expansion);
 
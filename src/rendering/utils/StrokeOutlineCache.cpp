@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StrokeOutlineCache.h"
+#include <functional>
+#include "rendering/caches/RenderCache.h"
+#include "rendering/utils/PathHasher.h"
+
+namespace pag {
+// Dashing a long path multiplies its points. Outlines above this size are stroked again in every
+// frame instead of crowding the cache.
+static constexpr int MaxCachedOutlinePoints = 8192;
+// Both the key path and the outline are kept. A point takes 8 bytes, doubled as an allowance for
+// the verbs and the path headers.
+static constexpr size_t OutlinePointMemory = 16;
+
+bool StrokeKey::operator==(const StrokeKey& other) const {
+  return strokeWidth == other.strokeWidth && lineCap == other.lineCap &&
+         lineJoin == other.lineJoin && miterLimit == other.miterLimit &&
+         dashOffset == other.dashOffset && dashes == other.dashes && matrix == other.matrix &&
+         path == other.path;
+}
+
+size_t StrokeKeyHasher::operator()(const StrokeKey& key) const {
+  std::hash<float> hasher = {};
+  auto hash = PathHasher()(key.path);
+  auto combine = [&](float value) {
+    hash ^= hasher(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  };
+  combine(key.strokeWidth);
+  combine(static_cast<float>(key.lineCap * 8 + key.lineJoin));
+  combine(key.miterLimit);
+  combine(key.dashOffset);
+  for (auto dash : key.dashes) {
+    combine(dash);
+  }
+  combine(key.matrix.getScaleX());
+  combine(key.matrix.getScaleY());
+  return hash;
+}
+
+static LRUCache<StrokeKey, tgfx::Path, StrokeKeyHasher>* GetCache() {
+  static auto cache = RenderCache::MakeSharedCache<StrokeKey, tgfx::Path, StrokeKeyHasher>();
+  return cache;
+}
+
+bool StrokeOutlineCache::Find(const StrokeKey& key, tgfx::Path* outline) {
+  return GetCache()->find(key, outline);
+}
+
+void StrokeOutlineCache::Add(const StrokeKey& key, const tgfx::Path& outline) {
+  if (key.path.countPoints() > MaxCachedOutlinePoints ||
+      outline.countPoints() > MaxCachedOutlinePoints) {
+    return;
+  }
+  auto pointCount = static_cast<size_t>(key.path.countPoints() + outline.countPoints());
+  GetCache()->add(key, outline, pointCount * OutlinePointMemory);
+}
+}  // namespace pag
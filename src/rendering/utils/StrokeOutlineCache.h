@@ -0,0 +1,67 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include "pag/types.h"
+#include "tgfx/core/Matrix.h"
+#include "tgfx/core/Path.h"
+
+namespace pag {
+/**
+ * Describes a stroke applied to a path, every parameter that affects the stroke outline is
+ * included.
+ */
+struct StrokeKey {
+  tgfx::Path path = {};
+  float strokeWidth = 0;
+  Enum lineCap = 0;
+  Enum lineJoin = 0;
+  float miterLimit = 0;
+  std::vector<float> dashes = {};
+  float dashOffset = 0;
+  tgfx::Matrix matrix = tgfx::Matrix::I();
+
+  bool operator==(const StrokeKey& other) const;
+};
+
+struct StrokeKeyHasher {
+  size_t operator()(const StrokeKey& key) const;
+};
+
+/**
+ * StrokeOutlineCache keeps the most recently computed stroke outlines within a memory limit, it is
+ * shared by all shapes of all players. Stroking a path, especially with dashes or round joins,
+ * costs much more than copying its outline back, which pays off for strokes whose geometry stays
+ * the same while their color or opacity animates.
+ */
+class StrokeOutlineCache {
+ public:
+  /**
+   * Copies the cached outline of the specified stroke to the outline path, returns false if it is
+   * not cached.
+   */
+  static bool Find(const StrokeKey& key, tgfx::Path* outline);
+
+  /**
+   * Adds the outline of the specified stroke to the cache.
+   */
+  static void Add(const StrokeKey& key, const tgfx::Path& outline);
+};
+}  // namespace pag
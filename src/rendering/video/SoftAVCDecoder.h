@@ -43,6 +43,11 @@ namespace pag {
  */
 class SoftAVCDecoder : public SoftwareDecoder {
  public:
+  /**
+   * Creates a SoftAVCDecoder which decodes each frame with the specified number of threads.
+   */
+  explicit SoftAVCDecoder(int numCores = 1);
+
   ~SoftAVCDecoder() override;
 
   bool onConfigure(const std::vector<HeaderData>& headers, std::string mime, int width,
@@ -65,6 +70,7 @@ class SoftAVCDecoder : public SoftwareDecoder {
   ivd_video_decode_ip_t decodeInput = {};
   ivd_video_decode_op_t decodeOutput = {};
   bool flushed = true;
+  int numCores = 1;
 
   bool initDecoder();
   bool openDecoder();
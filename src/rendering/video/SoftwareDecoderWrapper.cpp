@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SoftwareDecoderWrapper.h"
+#include "base/utils/Log.h"
 #include "platform/Platform.h"
 #include "rendering/video/SoftwareData.h"
 
@@ -148,13 +149,27 @@ std::shared_ptr<tgfx::ImageBuffer> SoftwareDecoderWrapper::onRenderFrame() {
   if (frame == nullptr) {
     return nullptr;
   }
-  auto yuvData =
-      SoftwareData<SoftwareDecoder>::Make(videoFormat.width, videoFormat.height, frame->data,
-                                          frame->lineSize, I420_PLANE_COUNT, softwareDecoder);
+  std::shared_ptr<tgfx::YUVData> yuvData = nullptr;
+  if (framePool != nullptr) {
+    yuvData = framePool->copyFrom(frame->data, frame->lineSize);
+    if (yuvData == nullptr) {
+      LOGE("SoftwareDecoderWrapper: Failed to copy the decoded frame into the frame pool.");
+      return nullptr;
+    }
+  } else {
+    yuvData =
+        SoftwareData<SoftwareDecoder>::Make(videoFormat.width, videoFormat.height, frame->data,
+                                            frame->lineSize, I420_PLANE_COUNT, softwareDecoder);
+  }
   return tgfx::ImageBuffer::MakeI420(std::move(yuvData), videoFormat.colorSpace);
 }
 
 int64_t SoftwareDecoderWrapper::presentationTime() {
   return currentDecodedTime;
 }
+
+bool SoftwareDecoderWrapper::setFramePool(std::shared_ptr<VideoFramePool> pool) {
+  framePool = std::move(pool);
+  return true;
+}
 }  // namespace pag
@@ -45,12 +45,15 @@ class SoftwareDecoderWrapper : public VideoDecoder {
 
   int64_t presentationTime() override;
 
+  bool setFramePool(std::shared_ptr<VideoFramePool> pool) override;
+
  private:
   std::shared_ptr<SoftwareDecoder> softwareDecoder = nullptr;
   VideoFormat videoFormat = {};
   tgfx::Buffer* frameBuffer = nullptr;
   int64_t currentDecodedTime = -1;
   std::list<int64_t> pendingFrames{};
+  std::shared_ptr<VideoFramePool> framePool = nullptr;
 
   explicit SoftwareDecoderWrapper(std::shared_ptr<SoftwareDecoder> externalDecoder);
 };
@@ -20,6 +20,7 @@
 
 #include "DecodingResult.h"
 #include "rendering/video/VideoFormat.h"
+#include "rendering/video/VideoFramePool.h"
 #include "tgfx/core/ImageBuffer.h"
 
 namespace pag {
@@ -66,6 +67,15 @@ class VideoDecoder {
    */
   virtual int64_t presentationTime() = 0;
 
+  /**
+   * Sets a VideoFramePool that decoded frames are copied into before being returned by
+   * onRenderFrame(), which keeps the returned ImageBuffers valid while later frames are decoded.
+   * Passing nullptr stops copying. Returns false if the decoder does not support frame pools.
+   */
+  virtual bool setFramePool(std::shared_ptr<VideoFramePool>) {
+    return false;
+  }
+
  private:
   bool hardwareBacked = false;
 
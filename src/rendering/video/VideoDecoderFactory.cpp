@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "VideoDecoderFactory.h"
+#include <algorithm>
 #include <atomic>
 #include "SoftAVCDecoder.h"
 #include "SoftwareDecoderWrapper.h"
@@ -28,10 +29,14 @@
 #endif
 
 namespace pag {
+// libavc supports at most 4 cores for decoding a single stream.
+static constexpr int MAX_SOFTWARE_DECODER_THREADS = 4;
+
 static std::mutex factoryLocker = {};
 static SoftwareDecoderFactory* softwareDecoderFactory = {nullptr};
 static std::atomic_int maxHardwareDecoderCount = {65535};
 static std::atomic_int globalHardwareDecoderCount = {0};
+static std::atomic_int softwareDecoderThreadCount = {1};
 
 void PAGVideoDecoder::RegisterSoftwareDecoderFactory(SoftwareDecoderFactory* decoderFactory) {
   std::lock_guard<std::mutex> autoLock(factoryLocker);
@@ -42,6 +47,10 @@ void PAGVideoDecoder::SetMaxHardwareDecoderCount(int count) {
   maxHardwareDecoderCount = count;
 }
 
+void PAGVideoDecoder::SetSoftwareDecoderThreadCount(int count) {
+  softwareDecoderThreadCount = std::max(1, std::min(count, MAX_SOFTWARE_DECODER_THREADS));
+}
+
 static SoftwareDecoderFactory* GetSoftwareDecoderFactory() {
   if (softwareDecoderFactory) {
     return softwareDecoderFactory;
@@ -82,7 +91,8 @@ class SoftwareAVCDecoderFactory : public VideoDecoderFactory {
   std::unique_ptr<VideoDecoder> onCreateDecoder(const VideoFormat& format) const override {
     std::unique_ptr<VideoDecoder> videoDecoder = nullptr;
 #ifdef PAG_USE_LIBAVC
-    videoDecoder = SoftwareDecoderWrapper::Wrap(std::make_shared<SoftAVCDecoder>(), format);
+    videoDecoder = SoftwareDecoderWrapper::Wrap(
+        std::make_shared<SoftAVCDecoder>(softwareDecoderThreadCount), format);
     if (videoDecoder != nullptr) {
       LOGI("All other video decoders are not available, fallback to SoftAVCDecoder!");
     }
@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoDecoderPool.h"
+#include <algorithm>
+#include <cstring>
+#include "base/utils/USE.h"
+#include "tgfx/utils/Clock.h"
+
+namespace pag {
+static bool IsSameFormat(const VideoFormat& a, const VideoFormat& b) {
+  if (a.mimeType != b.mimeType || a.width != b.width || a.height != b.height ||
+      a.colorSpace != b.colorSpace || a.headers.size() != b.headers.size()) {
+    return false;
+  }
+  // The decoders are configured with the headers (e.g. SPS and PPS of AVC), which may differ
+  // between videos of the same size.
+  for (size_t i = 0; i < a.headers.size(); i++) {
+    auto& headerA = a.headers[i];
+    auto& headerB = b.headers[i];
+    if (headerA->size() != headerB->size() ||
+        memcmp(headerA->data(), headerB->data(), headerA->size()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PAGVideoDecoder::SetMaxPooledDecoderCount(int count) {
+  VideoDecoderPool::GetInstance()->setMaxDecoderCount(count);
+}
+
+VideoDecoderPool* VideoDecoderPool::GetInstance() {
+  static auto& decoderPool = *new VideoDecoderPool();
+  return &decoderPool;
+}
+
+void VideoDecoderPool::setMaxDecoderCount(int count) {
+  std::list<IdleDecoder> expiredDecoders = {};
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    maxDecoderCount = static_cast<size_t>(std::max(count, 0));
+    while (idleDecoders.size() > maxDecoderCount) {
+      expiredDecoders.splice(expiredDecoders.end(), idleDecoders, std::prev(idleDecoders.end()));
+    }
+  }
+}
+
+void VideoDecoderPool::setMaxIdleTime(int64_t time) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  maxIdleTime = std::max(time, static_cast<int64_t>(0));
+}
+
+std::unique_ptr<VideoDecoder> VideoDecoderPool::obtain(const VideoDecoderFactory* factory,
+                                                       const VideoFormat& format) {
+  std::list<IdleDecoder> expiredDecoders = {};
+  std::lock_guard<std::mutex> autoLock(locker);
+  purgeExpiredDecoders(tgfx::Clock::Now(), &expiredDecoders);
+  for (auto iter = idleDecoders.begin(); iter != idleDecoders.end(); iter++) {
+    if (iter->factory == factory && IsSameFormat(iter->format, format)) {
+      auto decoder = std::move(iter->decoder);
+      idleDecoders.erase(iter);
+      return decoder;
+    }
+  }
+  return nullptr;
+}
+
+void VideoDecoderPool::recycle(const VideoDecoderFactory* factory, const VideoFormat& format,
+                               std::unique_ptr<VideoDecoder> decoder) {
+#ifdef PAG_BUILD_FOR_WEB
+  // The video decoders on the web platform hold a reference to the demuxer of the VideoReader.
+  USE(factory);
+  USE(format);
+  USE(decoder);
+#else
+  if (factory == nullptr || decoder == nullptr) {
+    return;
+  }
+  decoder->onFlush();
+  decoder->setFramePool(nullptr);
+  std::list<IdleDecoder> expiredDecoders = {};
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (maxDecoderCount == 0) {
+    expiredDecoders.push_back({factory, format, std::move(decoder), 0});
+    return;
+  }
+  auto currentTime = tgfx::Clock::Now();
+  purgeExpiredDecoders(currentTime, &expiredDecoders);
+  IdleDecoder idleDecoder = {factory, format, std::move(decoder), currentTime};
+  // The demuxer will be released along with the VideoReader.
+  idleDecoder.format.demuxer = nullptr;
+  idleDecoders.push_front(std::move(idleDecoder));
+  while (idleDecoders.size() > maxDecoderCount) {
+    expiredDecoders.splice(expiredDecoders.end(), idleDecoders, std::prev(idleDecoders.end()));
+  }
+#endif
+}
+
+bool VideoDecoderPool::purgeHardwareDecoders() {
+  std::list<IdleDecoder> expiredDecoders = {};
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto iter = idleDecoders.begin();
+  while (iter != idleDecoders.end()) {
+    auto current = iter++;
+    if (current->decoder->isHardwareBacked()) {
+      expiredDecoders.splice(expiredDecoders.end(), idleDecoders, current);
+    }
+  }
+  return !expiredDecoders.empty();
+}
+
+void VideoDecoderPool::purgeExpiredDecoders() {
+  std::list<IdleDecoder> expiredDecoders = {};
+  std::lock_guard<std::mutex> autoLock(locker);
+  purgeExpiredDecoders(tgfx::Clock::Now(), &expiredDecoders);
+}
+
+void VideoDecoderPool::purgeExpiredDecoders(int64_t currentTime,
+                                            std::list<IdleDecoder>* expiredDecoders) {
+  // The expired decoders are moved out and freed after the locker is released, since destroying a
+  // decoder may take a while.
+  // The idle decoders are sorted by release time in descending order.
+  while (!idleDecoders.empty() && currentTime - idleDecoders.back().releaseTime > maxIdleTime) {
+    expiredDecoders->splice(expiredDecoders->end(), idleDecoders, std::prev(idleDecoders.end()));
+  }
+}
+}  // namespace pag
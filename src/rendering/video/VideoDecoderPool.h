@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include "rendering/video/VideoDecoderFactory.h"
+
+namespace pag {
+/**
+ * VideoDecoderPool keeps the video decoders released by VideoReaders for a while, so that a new
+ * VideoReader decoding a video of the same format can take one of them over instead of paying the
+ * initialization cost of a new decoder. The pooled decoders are always flushed, and they are freed
+ * if not reused within a few seconds.
+ */
+class VideoDecoderPool {
+ public:
+  static VideoDecoderPool* GetInstance();
+
+  /**
+   * Sets the maximum number of idle decoders kept by the pool. Passing 0 disables pooling.
+   */
+  void setMaxDecoderCount(int count);
+
+  /**
+   * Sets the time in microseconds an idle decoder is kept before it is freed. The default value is
+   * 5 seconds.
+   */
+  void setMaxIdleTime(int64_t time);
+
+  /**
+   * Returns an idle decoder which was created by the specified factory for the same format, or
+   * nullptr if there is no such decoder in the pool.
+   */
+  std::unique_ptr<VideoDecoder> obtain(const VideoDecoderFactory* factory,
+                                       const VideoFormat& format);
+
+  /**
+   * Returns a decoder created by the specified factory for the format to the pool. The decoder is
+   * freed immediately if the pool is full or disabled.
+   */
+  void recycle(const VideoDecoderFactory* factory, const VideoFormat& format,
+               std::unique_ptr<VideoDecoder> decoder);
+
+  /**
+   * Frees all idle hardware decoders in the pool, which gives back the hardware decoder quota.
+   * Returns true if any decoder is freed.
+   */
+  bool purgeHardwareDecoders();
+
+  /**
+   * Frees the idle decoders which have not been reused within the max idle time. It is called by
+   * the RenderCaches at the end of every frame, so that the expired decoders are freed even if no
+   * video is opened or closed anymore.
+   */
+  void purgeExpiredDecoders();
+
+ private:
+  struct IdleDecoder {
+    const VideoDecoderFactory* factory = nullptr;
+    VideoFormat format = {};
+    std::unique_ptr<VideoDecoder> decoder = nullptr;
+    int64_t releaseTime = 0;
+  };
+
+  std::mutex locker = {};
+  size_t maxDecoderCount = 4;
+  int64_t maxIdleTime = 5000000;  // 5s
+  std::list<IdleDecoder> idleDecoders = {};
+
+  VideoDecoderPool() = default;
+
+  void purgeExpiredDecoders(int64_t currentTime, std::list<IdleDecoder>* expiredDecoders);
+};
+}  // namespace pag
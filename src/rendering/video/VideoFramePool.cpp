@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoFramePool.h"
+#include <cstring>
+
+namespace pag {
+#define I420_PLANE_COUNT 3
+
+class PooledYUVData : public tgfx::YUVData {
+ public:
+  PooledYUVData(std::shared_ptr<VideoFramePool> pool, uint8_t* buffer, int width, int height)
+      : pool(pool), buffer(buffer), _width(width), _height(height) {
+    auto uvWidth = (width + 1) / 2;
+    auto uvHeight = (height + 1) / 2;
+    planes[0] = buffer;
+    planes[1] = planes[0] + width * height;
+    planes[2] = planes[1] + uvWidth * uvHeight;
+    rowBytes[0] = static_cast<size_t>(width);
+    rowBytes[1] = static_cast<size_t>(uvWidth);
+    rowBytes[2] = static_cast<size_t>(uvWidth);
+  }
+
+  ~PooledYUVData() override {
+    auto framePool = pool.lock();
+    if (framePool) {
+      framePool->recycleBuffer(buffer);
+    } else {
+      delete[] buffer;
+    }
+  }
+
+  int width() const override {
+    return _width;
+  }
+
+  int height() const override {
+    return _height;
+  }
+
+  size_t planeCount() const override {
+    return I420_PLANE_COUNT;
+  }
+
+  const void* getBaseAddressAt(size_t planeIndex) const override {
+    return planes[planeIndex];
+  }
+
+  size_t getRowBytesAt(size_t planeIndex) const override {
+    return rowBytes[planeIndex];
+  }
+
+ private:
+  std::weak_ptr<VideoFramePool> pool;
+  uint8_t* buffer = nullptr;
+  int _width = 0;
+  int _height = 0;
+  uint8_t* planes[I420_PLANE_COUNT] = {};
+  size_t rowBytes[I420_PLANE_COUNT] = {};
+};
+
+static size_t GetFrameByteSize(int width, int height) {
+  auto uvWidth = static_cast<size_t>((width + 1) / 2);
+  auto uvHeight = static_cast<size_t>((height + 1) / 2);
+  return static_cast<size_t>(width) * static_cast<size_t>(height) + uvWidth * uvHeight * 2;
+}
+
+std::shared_ptr<VideoFramePool> VideoFramePool::Make(int width, int height, size_t maxBuffers) {
+  if (width <= 0 || height <= 0 || maxBuffers == 0) {
+    return nullptr;
+  }
+  auto pool = std::shared_ptr<VideoFramePool>(new VideoFramePool(width, height, maxBuffers));
+  pool->weakThis = pool;
+  return pool;
+}
+
+VideoFramePool::VideoFramePool(int width, int height, size_t maxBuffers)
+    : width(width), height(height), maxBuffers(maxBuffers) {
+}
+
+VideoFramePool::~VideoFramePool() {
+  for (auto buffer : freeBuffers) {
+    delete[] buffer;
+  }
+}
+
+std::shared_ptr<tgfx::YUVData> VideoFramePool::copyFrom(uint8_t* const data[3],
+                                                        const int lineSize[3]) {
+  auto buffer = obtainBuffer();
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  auto yuvData = std::make_shared<PooledYUVData>(weakThis.lock(), buffer, width, height);
+  for (size_t i = 0; i < I420_PLANE_COUNT; i++) {
+    auto planeHeight = i == 0 ? height : (height + 1) / 2;
+    auto dstRowBytes = yuvData->getRowBytesAt(i);
+    auto dst = static_cast<uint8_t*>(const_cast<void*>(yuvData->getBaseAddressAt(i)));
+    auto src = data[i];
+    for (int row = 0; row < planeHeight; row++) {
+      memcpy(dst, src, dstRowBytes);
+      dst += dstRowBytes;
+      src += lineSize[i];
+    }
+  }
+  return yuvData;
+}
+
+uint8_t* VideoFramePool::obtainBuffer() {
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (!freeBuffers.empty()) {
+      auto buffer = freeBuffers.back();
+      freeBuffers.pop_back();
+      return buffer;
+    }
+  }
+  return new (std::nothrow) uint8_t[GetFrameByteSize(width, height)];
+}
+
+void VideoFramePool::recycleBuffer(uint8_t* buffer) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (freeBuffers.size() < maxBuffers) {
+    freeBuffers.push_back(buffer);
+  } else {
+    delete[] buffer;
+  }
+}
+}  // namespace pag
@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2024 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include "tgfx/core/YUVData.h"
+
+namespace pag {
+/**
+ * VideoFramePool keeps a bounded number of I420 frame buffers that decoded video frames can be
+ * copied into. The output of a video decoder usually lives in memory owned by the decoder and is
+ * overwritten by the next decoded frame. Frames copied into the pool stay valid until the returned
+ * YUVData is released, after which the buffer is recycled for the next copy.
+ */
+class VideoFramePool {
+ public:
+  /**
+   * Creates a new VideoFramePool for frames of the specified size, which keeps at most maxBuffers
+   * released frame buffers for reusing. Returns nullptr if any of the parameters is invalid.
+   */
+  static std::shared_ptr<VideoFramePool> Make(int width, int height, size_t maxBuffers);
+
+  ~VideoFramePool();
+
+  /**
+   * Copies the I420 planes into a free buffer of the pool, a new buffer is allocated if all buffers
+   * of the pool are in use. Returns nullptr if failed to allocate the buffer.
+   */
+  std::shared_ptr<tgfx::YUVData> copyFrom(uint8_t* const data[3], const int lineSize[3]);
+
+ private:
+  std::mutex locker = {};
+  std::weak_ptr<VideoFramePool> weakThis;
+  int width = 0;
+  int height = 0;
+  size_t maxBuffers = 0;
+  std::vector<uint8_t*> freeBuffers = {};
+
+  VideoFramePool(int width, int height, size_t maxBuffers);
+
+  uint8_t* obtainBuffer();
+
+  void recycleBuffer(uint8_t* buffer);
+
+  friend class PooledYUVData;
+};
+}  // namespace pag
@@ -19,11 +19,17 @@
 #include <filesystem>
 #include "pag/pag.h"
 #include "platform/Platform.h"
+#include "rendering/CompositionReader.h"
 #include "rendering/caches/DiskCache.h"
 #include "rendering/utils/BitmapBuffer.h"
 #include "rendering/utils/Directory.h"
 #include "utils/TestUtils.h"
 
+#ifdef PAG_USE_C
+#include "c/pag_types_priv.h"
+#include "pag/c/pag_decoder.h"
+#endif
+
 namespace pag {
 
 //PAG_TEST(PAGDiskCacheTest, GenerateTestCaches) {
@@ -415,6 +421,274 @@ PAG_TEST(PAGDiskCacheTest, PAGDecoder_StaticTimeRanges) {
   pag::PAGDiskCache::RemoveAll();
 }
 
+PAG_TEST(PAGDiskCacheTest, PAGDecoder_StaticTimeRangesCache) {
+  pag::PAGDiskCache::RemoveAll();
+  auto pagFile = LoadPAGFile("resources/apitest/ImageDecodeTest.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto decoder = PAGDecoder::MakeFrom(pagFile, 24.0f);
+  ASSERT_TRUE(decoder != nullptr);
+  auto numFrames = decoder->numFrames();
+  auto timeRanges = PAGDecoder::AnalyzeStaticTimeRange(pagFile, numFrames);
+  EXPECT_EQ(decoder->staticTimeRanges.size(), 5u);
+  ASSERT_EQ(decoder->staticTimeRanges.size(), timeRanges.size());
+  EXPECT_TRUE(memcmp(decoder->staticTimeRanges.data(), timeRanges.data(),
+                     sizeof(TimeRange) * timeRanges.size()) == 0);
+  auto cacheKey = decoder->staticTimeRangesCacheKey(pagFile);
+  std::vector<TimeRange> cachedRanges = {};
+  EXPECT_TRUE(DiskCache::ReadStaticTimeRanges(cacheKey, numFrames, &cachedRanges));
+  EXPECT_EQ(cachedRanges.size(), timeRanges.size());
+  EXPECT_FALSE(DiskCache::ReadStaticTimeRanges(cacheKey, numFrames + 1, &cachedRanges));
+
+  // The decoders created later load the analysis from the disk cache.
+  std::vector<TimeRange> fakeRanges = {{0, 2}};
+  EXPECT_TRUE(DiskCache::WriteStaticTimeRanges(cacheKey, numFrames, fakeRanges));
+  decoder = PAGDecoder::MakeFrom(pagFile, 24.0f, 0.5f);
+  ASSERT_TRUE(decoder != nullptr);
+  ASSERT_EQ(decoder->staticTimeRanges.size(), 1u);
+  EXPECT_EQ(decoder->staticTimeRanges[0].end, 2);
+
+  // The time stretch mode changes how the frames are mapped, so it is part of the key.
+  pagFile->setTimeStretchMode(PAGTimeStretchMode::Scale);
+  EXPECT_NE(decoder->staticTimeRangesCacheKey(pagFile), cacheKey);
+  pagFile->setTimeStretchMode(PAGTimeStretchMode::Repeat);
+  EXPECT_EQ(decoder->staticTimeRangesCacheKey(pagFile), cacheKey);
+
+  // The key contains the hash of the file content, a different file replaced at the same path
+  // does not hit the cache of the previous one.
+  auto fileBytes = ByteData::FromPath(ProjectPath::Absolute("resources/apitest/test.pag"));
+  ASSERT_TRUE(fileBytes != nullptr);
+  auto otherFile = PAGFile::Load(fileBytes->data(), fileBytes->length());
+  ASSERT_TRUE(otherFile != nullptr);
+  EXPECT_NE(otherFile->file->contentHash, pagFile->file->contentHash);
+  EXPECT_NE(cacheKey.find(std::to_string(pagFile->file->contentHash)), std::string::npos);
+
+  // A generator returning an empty key disables the cache.
+  decoder->setCacheKeyGeneratorFun(
+      [](PAGDecoder*, std::shared_ptr<PAGComposition>) -> std::string { return ""; });
+  EXPECT_TRUE(decoder->staticTimeRangesCacheKey(pagFile).empty());
+  decoder->setCacheKeyGeneratorFun(
+      [](PAGDecoder*, std::shared_ptr<PAGComposition>) -> std::string { return "custom"; });
+  auto customKey = decoder->staticTimeRangesCacheKey(pagFile);
+  EXPECT_EQ(customKey.find("custom"), 0u);
+  EXPECT_TRUE(DiskCache::ReadStaticTimeRanges(customKey, numFrames, &cachedRanges));
+
+  // A modified file is analyzed again and never cached.
+  decoder->setCacheKeyGeneratorFun(nullptr);
+  pagFile->removeLayerAt(0);
+  EXPECT_TRUE(decoder->staticTimeRangesCacheKey(pagFile).empty());
+  decoder = nullptr;
+  pag::PAGDiskCache::RemoveAll();
+}
+
+PAG_TEST(PAGDiskCacheTest, PAGDecoder_ReadFrames) {
+  pag::PAGDiskCache::RemoveAll();
+  auto pagFile = LoadPAGFile("resources/apitest/ImageDecodeTest.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto decoder = PAGDecoder::MakeFrom(pagFile, 24.0f, 0.5f);
+  ASSERT_TRUE(decoder != nullptr);
+  pagFile = nullptr;
+  auto info = tgfx::ImageInfo::Make(decoder->width(), decoder->height(),
+                                    tgfx::ColorType::RGBA_8888, tgfx::AlphaType::Premultiplied);
+  int frameCount = 6;
+  int frameStride = 3;
+  std::vector<uint8_t> frames(info.byteSize() * frameCount);
+  auto count = decoder->readFrames(2, frameCount, frameStride, frames.data(), info.rowBytes(),
+                                   info.byteSize());
+  EXPECT_EQ(count, frameCount);
+  EXPECT_EQ(decoder->pendingIndex, -1);
+  EXPECT_TRUE(decoder->pendingBitmap == nullptr);
+  std::vector<uint8_t> frame(info.byteSize());
+  for (int i = 0; i < frameCount; i++) {
+    auto success = decoder->readFrame(2 + i * frameStride, frame.data(), info.rowBytes());
+    EXPECT_TRUE(success);
+    EXPECT_TRUE(memcmp(frame.data(), frames.data() + info.byteSize() * i, info.byteSize()) == 0);
+  }
+  count = decoder->readFrames(decoder->numFrames() - 2, 4, 1, frames.data(), info.rowBytes(),
+                              info.byteSize());
+  EXPECT_EQ(count, 2);
+  count = decoder->readFrames(0, 2, 1, frames.data(), info.rowBytes(), info.byteSize() - 1);
+  EXPECT_EQ(count, 0);
+  decoder = nullptr;
+  pag::PAGDiskCache::RemoveAll();
+}
+
+PAG_TEST(PAGDiskCacheTest, PAGDecoder_PartialInvalidation) {
+  auto makeComposition = [](std::shared_ptr<PAGSolidLayer>* secondLayer) {
+    auto composition = PAGComposition::Make(100, 100);
+    composition->addLayer(PAGSolidLayer::Make(1000000, 100, 100, Red));
+    *secondLayer = PAGSolidLayer::Make(1000000, 50, 50, Blue);
+    (*secondLayer)->setStartTime(1000000);
+    composition->addLayer(*secondLayer);
+    return composition;
+  };
+  std::shared_ptr<PAGSolidLayer> solidLayer = nullptr;
+  auto decoder = PAGDecoder::MakeFrom(makeComposition(&solidLayer), 30);
+  ASSERT_TRUE(decoder != nullptr);
+  auto numFrames = decoder->numFrames();
+  auto info = tgfx::ImageInfo::Make(decoder->width(), decoder->height(),
+                                    tgfx::ColorType::RGBA_8888, tgfx::AlphaType::Premultiplied);
+  std::vector<uint8_t> frame(info.byteSize());
+  for (int i = 0; i < numFrames; i++) {
+    EXPECT_TRUE(decoder->readFrame(i, frame.data(), info.rowBytes()));
+  }
+  solidLayer->setSolidColor(Green);
+  EXPECT_TRUE(decoder->checkFrameChanged(numFrames - 1));
+  ASSERT_TRUE(decoder->previousSequenceFile != nullptr);
+  ASSERT_EQ(decoder->changedTimeRanges.size(), 1u);
+  EXPECT_GE(decoder->changedTimeRanges[0].start, numFrames / 2 - 2);
+  EXPECT_GE(decoder->changedTimeRanges[0].end, numFrames - 1);
+
+  std::shared_ptr<PAGSolidLayer> expectedLayer = nullptr;
+  auto expectedDecoder = PAGDecoder::MakeFrom(makeComposition(&expectedLayer), 30);
+  ASSERT_TRUE(expectedDecoder != nullptr);
+  expectedLayer->setSolidColor(Green);
+  std::vector<uint8_t> expectedFrame(info.byteSize());
+  for (int i = 0; i < numFrames; i++) {
+    EXPECT_TRUE(decoder->readFrame(i, frame.data(), info.rowBytes()));
+    EXPECT_TRUE(expectedDecoder->readFrame(i, expectedFrame.data(), info.rowBytes()));
+    EXPECT_TRUE(memcmp(frame.data(), expectedFrame.data(), info.byteSize()) == 0);
+  }
+  EXPECT_TRUE(decoder->previousSequenceFile == nullptr);
+}
+
+#ifdef PAG_USE_C
+/**
+ * 用例描述: C 接口借用的帧缓存在相同的帧、格式和内容版本之间共享，空闲缓存最多保留两个
+ */
+PAG_TEST(PAGDiskCacheTest, CDecoder_AcquireFrame) {
+  auto composition = PAGComposition::Make(100, 100);
+  auto solidLayer = PAGSolidLayer::Make(1000000, 100, 100, Red);
+  composition->addLayer(solidLayer);
+  auto cComposition = new pag_layer(composition);
+  auto decoder = pag_decoder_create(cComposition, 30, 1.0f);
+  ASSERT_TRUE(decoder != nullptr);
+  auto info = tgfx::ImageInfo::Make(pag_decoder_get_width(decoder),
+                                    pag_decoder_get_height(decoder), tgfx::ColorType::RGBA_8888,
+                                    tgfx::AlphaType::Premultiplied);
+  size_t rowBytes = 0;
+  auto pixels = pag_decoder_acquire_frame(decoder, 0, pag_color_type_rgba_8888,
+                                          pag_alpha_type_premultiplied, &rowBytes);
+  ASSERT_TRUE(pixels != nullptr);
+  EXPECT_EQ(rowBytes, info.rowBytes());
+  std::vector<uint8_t> frame(info.byteSize());
+  EXPECT_TRUE(pag_decoder_read_frame(decoder, 0, frame.data(), info.rowBytes(),
+                                     pag_color_type_rgba_8888, pag_alpha_type_premultiplied));
+  EXPECT_TRUE(memcmp(pixels, frame.data(), info.byteSize()) == 0);
+  // 相同的帧和格式共享同一块缓存，不会重新解码。
+  auto sharedPixels = pag_decoder_acquire_frame(decoder, 0, pag_color_type_rgba_8888,
+                                                pag_alpha_type_premultiplied, &rowBytes);
+  EXPECT_EQ(sharedPixels, pixels);
+  ASSERT_EQ(decoder->frameBuffers.size(), 1u);
+  EXPECT_EQ(decoder->frameBuffers[0].refCount, 2);
+  // 颜色类型或透明类型不同时不能借到已有的缓存。
+  EXPECT_NE(pag_decoder_acquire_frame(decoder, 0, pag_color_type_bgra_8888,
+                                      pag_alpha_type_premultiplied, &rowBytes),
+            pixels);
+  EXPECT_NE(pag_decoder_acquire_frame(decoder, 0, pag_color_type_rgba_8888,
+                                      pag_alpha_type_unpremultiplied, &rowBytes),
+            pixels);
+
+  // 编辑图层后借到的是新内容，之前借出的缓存保持不变。
+  std::vector<uint8_t> redFrame(frame);
+  solidLayer->setSolidColor(Green);
+  auto editedPixels = pag_decoder_acquire_frame(decoder, 0, pag_color_type_rgba_8888,
+                                                pag_alpha_type_premultiplied, &rowBytes);
+  ASSERT_TRUE(editedPixels != nullptr);
+  EXPECT_NE(editedPixels, pixels);
+  EXPECT_TRUE(memcmp(pixels, redFrame.data(), info.byteSize()) == 0);
+  EXPECT_TRUE(pag_decoder_read_frame(decoder, 0, frame.data(), info.rowBytes(),
+                                     pag_color_type_rgba_8888, pag_alpha_type_premultiplied));
+  EXPECT_FALSE(memcmp(frame.data(), redFrame.data(), info.byteSize()) == 0);
+  EXPECT_TRUE(memcmp(editedPixels, frame.data(), info.byteSize()) == 0);
+  pag_decoder_release_frame(decoder, pixels);
+  pag_decoder_release_frame(decoder, sharedPixels);
+  pag_decoder_release_frame(decoder, editedPixels);
+
+  // 全部归还后最多保留两个空闲缓存，最后归还的缓存可以被再次借用。
+  std::vector<const void*> borrowedFrames = {};
+  for (int i = 0; i < 5; i++) {
+    auto framePixels = pag_decoder_acquire_frame(decoder, i * 5, pag_color_type_rgba_8888,
+                                                 pag_alpha_type_premultiplied, &rowBytes);
+    ASSERT_TRUE(framePixels != nullptr);
+    borrowedFrames.push_back(framePixels);
+  }
+  EXPECT_GE(decoder->frameBuffers.size(), 5u);
+  for (auto framePixels : borrowedFrames) {
+    pag_decoder_release_frame(decoder, framePixels);
+  }
+  EXPECT_EQ(decoder->frameBuffers.size(), 2u);
+  for (auto& frameBuffer : decoder->frameBuffers) {
+    EXPECT_EQ(frameBuffer.refCount, 0);
+  }
+  EXPECT_EQ(pag_decoder_acquire_frame(decoder, 20, pag_color_type_rgba_8888,
+                                      pag_alpha_type_premultiplied, &rowBytes),
+            borrowedFrames.back());
+  pag_decoder_release_frame(decoder, borrowedFrames.back());
+  pag_release(decoder);
+  pag_release(cComposition);
+}
+
+/**
+ * 用例描述: C 接口批量读取的每一帧与逐帧读取一致，超出范围时只返回读取成功的帧数
+ */
+PAG_TEST(PAGDiskCacheTest, CDecoder_ReadFrames) {
+  auto composition = PAGComposition::Make(100, 100);
+  composition->addLayer(PAGSolidLayer::Make(1000000, 100, 100, Red));
+  auto solidLayer = PAGSolidLayer::Make(1000000, 50, 50, Blue);
+  solidLayer->setStartTime(500000);
+  composition->addLayer(solidLayer);
+  auto cComposition = new pag_layer(composition);
+  auto decoder = pag_decoder_create(cComposition, 30, 1.0f);
+  ASSERT_TRUE(decoder != nullptr);
+  auto numFrames = pag_decoder_get_num_frames(decoder);
+  auto info = tgfx::ImageInfo::Make(pag_decoder_get_width(decoder),
+                                    pag_decoder_get_height(decoder), tgfx::ColorType::RGBA_8888,
+                                    tgfx::AlphaType::Premultiplied);
+  int frameCount = 5;
+  int frameStride = 6;
+  std::vector<uint8_t> frames(info.byteSize() * frameCount);
+  auto count = pag_decoder_read_frames(decoder, 1, frameCount, frameStride, frames.data(),
+                                       info.rowBytes(), info.byteSize(), pag_color_type_rgba_8888,
+                                       pag_alpha_type_premultiplied);
+  EXPECT_EQ(count, frameCount);
+  std::vector<uint8_t> frame(info.byteSize());
+  for (int i = 0; i < frameCount; i++) {
+    EXPECT_TRUE(pag_decoder_read_frame(decoder, 1 + i * frameStride, frame.data(),
+                                       info.rowBytes(), pag_color_type_rgba_8888,
+                                       pag_alpha_type_premultiplied));
+    EXPECT_TRUE(memcmp(frame.data(), frames.data() + info.byteSize() * i, info.byteSize()) == 0);
+  }
+  count = pag_decoder_read_frames(decoder, numFrames - 2, 4, 1, frames.data(), info.rowBytes(),
+                                  info.byteSize(), pag_color_type_rgba_8888,
+                                  pag_alpha_type_premultiplied);
+  EXPECT_EQ(count, 2);
+  count = pag_decoder_read_frames(decoder, 0, 2, 1, frames.data(), info.rowBytes(),
+                                  info.byteSize(), pag_color_type_unknown,
+                                  pag_alpha_type_premultiplied);
+  EXPECT_EQ(count, 0);
+  pag_release(decoder);
+  pag_release(cComposition);
+}
+#endif
+
+PAG_TEST(PAGDiskCacheTest, CompositionReader_ReadFrameAsync) {
+  auto pagFile = LoadPAGFile("resources/apitest/ImageDecodeTest.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto reader = CompositionReader::Make(pagFile->width(), pagFile->height());
+  ASSERT_TRUE(reader != nullptr);
+  reader->setComposition(pagFile);
+  auto info = tgfx::ImageInfo::Make(reader->width(), reader->height(), tgfx::ColorType::RGBA_8888,
+                                    tgfx::AlphaType::Premultiplied);
+  std::vector<uint8_t> syncPixels(info.byteSize());
+  std::vector<uint8_t> asyncPixels(info.byteSize());
+  EXPECT_FALSE(reader->waitFrame());
+  reader->readFrameAsync(0.5, BitmapBuffer::Wrap(info, asyncPixels.data()));
+  EXPECT_TRUE(reader->waitFrame());
+  EXPECT_FALSE(reader->waitFrame());
+  EXPECT_TRUE(reader->readFrame(0.5, BitmapBuffer::Wrap(info, syncPixels.data())));
+  EXPECT_TRUE(memcmp(syncPixels.data(), asyncPixels.data(), info.byteSize()) == 0);
+}
+
 PAG_TEST(PAGDiskCacheTest, FileCache) {
   pag::PAGDiskCache::RemoveAll();
   auto data = ReadFile("resources/apitest/polygon.pag");
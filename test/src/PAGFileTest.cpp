@@ -16,8 +16,14 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <chrono>
+#include <thread>
+#include "base/Keyframes.h"
 #include "base/utils/TimeUtil.h"
+#include "codec/utils/DecodeStream.h"
+#include "codec/utils/EncodeStream.h"
 #include "nlohmann/json.hpp"
+#include "rendering/caches/PreloadedImageCache.h"
 #include "utils/TestUtils.h"
 
 #define PAG_COMPLEX_FILE_PATH TestConstants::PAG_ROOT + "resources/apitest/complex_test.pag"
@@ -718,4 +724,243 @@ PAG_TEST(PAGFileTest, EditableIndices) {
   ASSERT_EQ(editableTexts[1], static_cast<int>(0));
 }
 
+/**
+ * 用例描述: DecodeStream 批量解码位列表的结果与逐个读取一致
+ */
+PAG_TEST(PAGFileTest, DecodeStreamBitList) {
+  const uint32_t pointCount = 1000;
+  const float precision = 0.05f;
+  std::vector<Point> points(pointCount);
+  for (uint32_t i = 0; i < pointCount; i++) {
+    points[i].x = static_cast<float>(i % 1999) * 0.7f - 600.0f;
+    points[i].y = static_cast<float>(i % 313) * -1.3f + 150.0f;
+  }
+  StreamContext context = {};
+  EncodeStream encoder(&context);
+  encoder.writePoint2DList(points.data(), pointCount, precision);
+  // 末尾不足 8 个字节时走逐字节读取的分支。
+  encoder.writeUint8(1);
+  auto bytes = encoder.release();
+
+  // 参考实现：逐个分量读取。
+  std::vector<Point> expected(pointCount);
+  DecodeStream referenceStream(&context, bytes->data(), static_cast<uint32_t>(bytes->length()));
+  auto numBits = referenceStream.readNumBits();
+  for (uint32_t i = 0; i < pointCount; i++) {
+    expected[i].x = referenceStream.readBits(numBits) * precision;
+    expected[i].y = referenceStream.readBits(numBits) * precision;
+  }
+
+  std::vector<Point> result(pointCount);
+  DecodeStream stream(&context, bytes->data(), static_cast<uint32_t>(bytes->length()));
+  stream.readPoint2DList(result.data(), pointCount, precision);
+  EXPECT_FALSE(context.hasException());
+  EXPECT_EQ(stream.position(), referenceStream.position());
+  for (uint32_t i = 0; i < pointCount; i++) {
+    ASSERT_EQ(result[i].x, expected[i].x);
+    ASSERT_EQ(result[i].y, expected[i].y);
+  }
+
+  // 数据不足时与逐个读取一样抛出异常。
+  StreamContext truncatedContext = {};
+  DecodeStream truncatedStream(&truncatedContext, bytes->data(), 16);
+  truncatedStream.readPoint2DList(result.data(), pointCount, precision);
+  EXPECT_TRUE(truncatedContext.hasException());
+}
+
+/**
+ * 用例描述: 解码后同一属性的关键帧连续存放在一块内存中
+ */
+PAG_TEST(PAGFileTest, PackedKeyframes) {
+  int packedCount = 0;
+  auto maxOffset = PackedKeyframeSize(sizeof(SingleEaseKeyframe<Opacity>));
+  for (auto& path : GetAllPAGFiles("resources/apitest")) {
+    auto file = File::Load(path);
+    ASSERT_TRUE(file != nullptr);
+    for (auto composition : file->compositions) {
+      if (composition->type() != CompositionType::Vector) {
+        continue;
+      }
+      for (auto layer : static_cast<VectorComposition*>(composition)->layers) {
+        if (layer->transform == nullptr || !layer->transform->opacity->animatable()) {
+          continue;
+        }
+        auto opacity = layer->transform->opacity;
+        auto property = dynamic_cast<PackedAnimatableProperty<Opacity>*>(opacity);
+        ASSERT_TRUE(property != nullptr);
+        auto& keyframes = property->keyframes;
+        for (size_t i = 1; i < keyframes.size(); i++) {
+          auto offset = reinterpret_cast<uint8_t*>(keyframes[i]) -
+                        reinterpret_cast<uint8_t*>(keyframes[i - 1]);
+          EXPECT_GT(offset, 0);
+          EXPECT_LE(static_cast<size_t>(offset), maxOffset);
+        }
+        packedCount++;
+      }
+    }
+  }
+  EXPECT_GT(packedCount, 0);
+}
+
+/**
+ * 用例描述: PAGFile preload 接口，并行解码文件内的图片，首次渲染时取走预解码的结果，未使用的结果会过期释放
+ */
+PAG_TEST(PAGFileTest, Preload) {
+  auto pagFile = LoadPAGFile("resources/apitest/complex_test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto file = pagFile->getFile();
+  ASSERT_FALSE(file->images.empty());
+  auto imageCache = PreloadedImageCache::GetInstance();
+  auto countPreloadedImages = [&]() {
+    size_t count = 0;
+    for (auto imageBytes : file->images) {
+      if (imageCache->contains(imageBytes->uniqueID)) {
+        count++;
+      }
+    }
+    return count;
+  };
+  EXPECT_TRUE(pagFile->preload(FrameToTime(1, file->frameRate())));
+  EXPECT_TRUE(pagFile->preload());
+  auto preloadedCount = countPreloadedImages();
+  EXPECT_GT(preloadedCount, 0u);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  EXPECT_TRUE(pagPlayer->flush());
+  // 首帧绘制的图片被渲染缓存取走。
+  EXPECT_LT(countPreloadedImages(), preloadedCount);
+
+  // 超过最大空闲时间未被取走的图片在下一帧结束时释放。
+  EXPECT_TRUE(pagFile->preload());
+  EXPECT_GT(countPreloadedImages(), 0u);
+  imageCache->setMaxIdleTime(0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  pagPlayer->setProgress(0.5);
+  pagPlayer->flush();
+  EXPECT_EQ(countPreloadedImages(), 0u);
+  imageCache->setMaxIdleTime(5000000);
+}
+
+/**
+ * 用例描述: 解码时不登记可烘焙属性，烘焙时由当前线程遍历图层收集
+ */
+PAG_TEST(PAGFileTest, BakeablePropertyCollector) {
+  std::unique_ptr<uint8_t[]> storage(new uint8_t[PackedKeyframeSize(sizeof(Keyframe<float>))]);
+  auto keyframe = new (storage.get()) Keyframe<float>();
+  keyframe->startValue = 1.0f;
+  keyframe->endValue = 2.0f;
+  keyframe->startTime = 0;
+  keyframe->endTime = 10;
+  auto property = std::make_unique<PackedAnimatableProperty<float>>(
+      std::vector<Keyframe<float>*>{keyframe}, std::move(storage));
+  std::vector<TimeRange> timeRanges = {{0, 20}};
+  {
+    BakeablePropertyCollector collector = {};
+    property->excludeVaryingRanges(&timeRanges);
+    property->excludeVaryingRanges(&timeRanges);
+    EXPECT_EQ(collector.properties().size(), 1lu);
+    // 其他线程遍历到的属性不会进入当前线程的收集器。
+    BakeablePropertyCollector nestedCollector = {};
+    std::thread walker([&]() {
+      std::vector<TimeRange> otherRanges = {{0, 20}};
+      property->excludeVaryingRanges(&otherRanges);
+    });
+    walker.join();
+    EXPECT_TRUE(nestedCollector.properties().empty());
+  }
+  EXPECT_EQ(property->bake(100), 11 * sizeof(float));
+  EXPECT_EQ(property->getValueAt(5), 1.0f);
+
+  auto byteData = ByteData::FromPath(ProjectPath::Absolute("resources/apitest/complex_test.pag"));
+  ASSERT_TRUE(byteData != nullptr);
+  auto file = File::Load(byteData->data(), byteData->length());
+  ASSERT_TRUE(file != nullptr);
+  BakeablePropertyCollector collector = {};
+  for (auto composition : file->compositions) {
+    if (composition->type() == CompositionType::Vector) {
+      for (auto layer : static_cast<VectorComposition*>(composition)->layers) {
+        layer->excludeVaryingRanges(&timeRanges);
+      }
+    }
+  }
+  EXPECT_FALSE(collector.properties().empty());
+}
+
+/**
+ * 用例描述: PAGFile bakeTimeline 烘焙后的取值和渲染结果与关键帧插值一致
+ */
+PAG_TEST(PAGFileTest, BakeTimeline) {
+  auto byteData = ByteData::FromPath(ProjectPath::Absolute("resources/apitest/complex_test.pag"));
+  ASSERT_TRUE(byteData != nullptr);
+  // 不指定路径，避免两次加载得到同一个 File。
+  auto file = File::Load(byteData->data(), byteData->length());
+  auto bakedFile = File::Load(byteData->data(), byteData->length());
+  ASSERT_TRUE(file != nullptr && bakedFile != nullptr);
+  ASSERT_NE(file, bakedFile);
+  auto bakedBytes = bakedFile->bakeTimeline();
+  EXPECT_GT(bakedBytes, 0lu);
+  EXPECT_EQ(bakedFile->bakeTimeline(), bakedBytes);
+
+  auto evaluate = [](File* target, std::vector<float>* values) {
+    for (auto composition : target->compositions) {
+      if (composition->type() != CompositionType::Vector) {
+        continue;
+      }
+      for (auto layer : static_cast<VectorComposition*>(composition)->layers) {
+        auto transform = layer->transform;
+        if (transform == nullptr) {
+          continue;
+        }
+        // 包含首尾关键帧之外的帧，覆盖查表时的边界截断。
+        for (Frame frame = -1; frame <= composition->duration + 1; frame++) {
+          if (transform->position != nullptr) {
+            auto position = transform->position->getValueAt(frame);
+            values->push_back(position.x);
+            values->push_back(position.y);
+          } else {
+            values->push_back(transform->xPosition->getValueAt(frame));
+            values->push_back(transform->yPosition->getValueAt(frame));
+          }
+          auto scale = transform->scale->getValueAt(frame);
+          values->push_back(scale.x);
+          values->push_back(scale.y);
+          values->push_back(transform->rotation->getValueAt(frame));
+          values->push_back(transform->opacity->getValueAt(frame));
+        }
+      }
+    }
+  };
+  std::vector<float> values = {};
+  evaluate(file.get(), &values);
+  std::vector<float> bakedValues = {};
+  evaluate(bakedFile.get(), &bakedValues);
+  ASSERT_EQ(values.size(), bakedValues.size());
+  EXPECT_TRUE(memcmp(values.data(), bakedValues.data(), values.size() * sizeof(float)) == 0);
+
+  // 烘焙后的文件渲染结果不变。
+  auto pagFile = PAGFile::MakeFrom(file);
+  auto bakedPAGFile = PAGFile::MakeFrom(bakedFile);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto bakedSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto bakedPlayer = std::make_unique<PAGPlayer>();
+  bakedPlayer->setSurface(bakedSurface);
+  bakedPlayer->setComposition(bakedPAGFile);
+  pagPlayer->setProgress(0.5);
+  bakedPlayer->setProgress(0.5);
+  pagPlayer->flush();
+  bakedPlayer->flush();
+  auto bitmap = MakeSnapshot(pagSurface);
+  auto bakedBitmap = MakeSnapshot(bakedSurface);
+  tgfx::Pixmap pixmap(bitmap);
+  tgfx::Pixmap bakedPixmap(bakedBitmap);
+  ASSERT_EQ(pixmap.info().byteSize(), bakedPixmap.info().byteSize());
+  EXPECT_TRUE(memcmp(pixmap.pixels(), bakedPixmap.pixels(), pixmap.info().byteSize()) == 0);
+}
+
 }  // namespace pag
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <filesystem>
+#include "rendering/graphics/GradientPaint.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -37,4 +38,47 @@ PAG_TEST(PAGGradientColorTest, GradientColor) {
     EXPECT_TRUE(Baseline::Compare(TestPAGSurface, "PAGGradientColorTest/" + key.string()));
   }
 }
+
+/**
+ * 用例描述: 色标相同的渐变共享同一份烘焙好的色带
+ */
+PAG_TEST(PAGGradientColorTest, GradientRampCache) {
+  auto makeGradientColor = [](Color middleColor) {
+    auto gradientColor = std::make_shared<GradientColor>();
+    gradientColor->colorStops = {{0.0f, 0.5f, Red}, {0.4f, 0.3f, middleColor}, {1.0f, 0.5f, Blue}};
+    gradientColor->alphaStops = {{0.0f, 0.5f, Opaque}, {0.7f, 0.5f, 128}};
+    return gradientColor;
+  };
+  auto matrix = tgfx::Matrix::I();
+  GradientPaint gradient(GradientFillType::Linear, Point::Zero(), Point::Make(100, 0),
+                         makeGradientColor(Green), matrix);
+  GradientPaint sameGradient(GradientFillType::Radial, Point::Make(10, 10), Point::Make(50, 50),
+                             makeGradientColor(Green), tgfx::Matrix::MakeScale(2));
+  EXPECT_EQ(gradient.ramp, sameGradient.ramp);
+  GradientPaint otherGradient(GradientFillType::Linear, Point::Zero(), Point::Make(100, 0),
+                              makeGradientColor(White), matrix);
+  EXPECT_NE(gradient.ramp, otherGradient.ramp);
+  GradientPaint reversedGradient(GradientFillType::Linear, Point::Zero(), Point::Make(100, 0),
+                                 makeGradientColor(Green), matrix, true);
+  ASSERT_NE(gradient.ramp, reversedGradient.ramp);
+  GradientPaint animatedGradient(GradientFillType::Linear, Point::Zero(), Point::Make(100, 0),
+                                 makeGradientColor(Green), matrix, false, true);
+  EXPECT_NE(gradient.ramp, animatedGradient.ramp);
+  EXPECT_EQ(animatedGradient.ramp->positions, gradient.ramp->positions);
+
+  auto& ramp = *gradient.ramp;
+  auto& reversedRamp = *reversedGradient.ramp;
+  ASSERT_EQ(ramp.colors.size(), ramp.positions.size());
+  ASSERT_EQ(ramp.colors.size(), reversedRamp.colors.size());
+  auto count = ramp.positions.size();
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_FLOAT_EQ(reversedRamp.positions[count - 1 - i], 1.0f - ramp.positions[i]);
+    EXPECT_TRUE(reversedRamp.colors[count - 1 - i] == ramp.colors[i]);
+  }
+  ASSERT_EQ(ramp.reflectedPositions.size(), count * 2 - 1);
+  EXPECT_FLOAT_EQ(ramp.reflectedPositions[count - 1], 0.5f);
+  EXPECT_TRUE(ramp.reflectedColors.front() == ramp.colors.back());
+  EXPECT_TRUE(ramp.reflectedColors.back() == ramp.colors.back());
+  EXPECT_TRUE(gradient.getShader() != nullptr);
+}
 }  // namespace pag
@@ -234,4 +234,57 @@ PAG_TEST(PAGImageLayerTest, trackmatteImageLayer) {
   EXPECT_EQ(timeRange.start, -13);
   EXPECT_EQ(timeRange.end, 66);
 }
+
+/**
+ * 用例描述: 测试像素级碰撞检测的结果与实际绘制的像素一致，并且碰撞检测生成的 AlphaMask 计入缓存内存。
+ */
+PAG_TEST(PAGImageLayerTest, pixelHitTest) {
+  auto image = MakePAGImage("resources/apitest/imageReplacement.png");
+  ASSERT_NE(image, nullptr);
+  auto width = image->width();
+  auto height = image->height();
+  auto imageLayer = PAGImageLayer::Make(width, height, 1000000);
+  ASSERT_NE(imageLayer, nullptr);
+  imageLayer->setImage(image);
+  auto composition = PAGComposition::Make(width, height);
+  composition->addLayer(imageLayer);
+  auto pagSurface = OffscreenSurface::Make(width, height);
+  ASSERT_NE(pagSurface, nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(composition);
+  pagPlayer->flush();
+  tgfx::Bitmap bitmap(width, height, false, false);
+  tgfx::Pixmap pixmap(bitmap);
+  ASSERT_FALSE(pixmap.isEmpty());
+  auto result = pagSurface->readPixels(ToPAG(pixmap.colorType()), ToPAG(pixmap.alphaType()),
+                                       pixmap.writablePixels(), pixmap.rowBytes());
+  ASSERT_TRUE(result);
+
+  auto memoryBefore = pagPlayer->renderCache->memoryUsage();
+  auto pixels = reinterpret_cast<const uint8_t*>(pixmap.pixels());
+  int hitCount = 0;
+  int missCount = 0;
+  for (int y = 0; y < height; y += 7) {
+    for (int x = 0; x < width; x += 7) {
+      auto alpha = pixels[y * pixmap.rowBytes() + x * 4 + 3];
+      auto hit = pagPlayer->hitTestPoint(imageLayer, static_cast<float>(x) + 0.5f,
+                                         static_cast<float>(y) + 0.5f, true);
+      EXPECT_EQ(hit, alpha > 0) << "x: " << x << ", y: " << y;
+      if (hit) {
+        hitCount++;
+      } else {
+        missCount++;
+      }
+    }
+  }
+  // 图片同时包含透明和不透明的区域。
+  EXPECT_GT(hitCount, 0);
+  EXPECT_GT(missCount, 0);
+  auto snapshot = pagPlayer->renderCache->getSnapshot(image->uniqueID());
+  ASSERT_NE(snapshot, nullptr);
+  ASSERT_NE(snapshot->alphaMask, nullptr);
+  EXPECT_EQ(pagPlayer->renderCache->memoryUsage(),
+            memoryBefore + snapshot->alphaMask->memoryUsage());
+}
 }  // namespace pag
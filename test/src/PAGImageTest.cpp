@@ -16,6 +16,7 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
 #include <thread>
 #include "nlohmann/json.hpp"
 #include "pag/pag.h"
@@ -136,6 +137,46 @@ PAG_TEST(PAGImageTest, image3) {
   EXPECT_TRUE(Baseline::Compare(surface, "PAGImageTest/image3"));
 }
 
+/**
+ * 用例描述: 缩小显示的PAGImage按显示比例解码，内存中不保留原始尺寸的图片
+ */
+PAG_TEST(PAGImageTest, DecodeScale) {
+  auto pagImage = MakePAGImage("resources/apitest/rotation.jpg");
+  ASSERT_TRUE(pagImage != nullptr);
+  auto pagFile = LoadPAGFile("resources/apitest/replace2.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  pagFile->replaceImage(0, pagImage);
+  auto surface = OffscreenSurface::Make(720, 720);
+  ASSERT_TRUE(surface != nullptr);
+  auto player = std::make_unique<PAGPlayer>();
+  player->setComposition(pagFile);
+  player->setSurface(surface);
+  EXPECT_TRUE(player->flush());
+  auto renderCache = player->renderCache;
+  auto image = renderCache->assetImages[pagImage->uniqueID()];
+  ASSERT_TRUE(image != nullptr);
+  EXPECT_LT(image->width(), pagImage->width());
+  EXPECT_LT(image->height(), pagImage->height());
+  // 按不小于显示比例的 2 的幂次分之一解码。
+  auto maxScale = renderCache->stage->getAssetMaxScale(pagImage->uniqueID());
+  auto decodeScale = renderCache->assetDecodeScales[pagImage->uniqueID()];
+  EXPECT_GE(decodeScale, maxScale);
+  EXPECT_LT(decodeScale, maxScale * 2);
+  EXPECT_EQ(decodeScale, exp2f(roundf(log2f(decodeScale))));
+  auto width = static_cast<int>(ceilf(static_cast<float>(pagImage->width()) * decodeScale));
+  EXPECT_EQ(image->width(), width);
+  auto snapshot = renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  auto snapshotWidth = static_cast<int>(ceilf(static_cast<float>(pagImage->width()) * maxScale));
+  EXPECT_LE(abs(snapshot->getImage()->width() - snapshotWidth), 1);
+
+  // 显示比例小幅变化时复用已解码的图片，不重新解码。
+  pagFile->setMatrix(Matrix::MakeScale(0.9f));
+  EXPECT_TRUE(player->flush());
+  EXPECT_LT(renderCache->stage->getAssetMaxScale(pagImage->uniqueID()), maxScale);
+  EXPECT_EQ(renderCache->assetImages[pagImage->uniqueID()], image);
+}
+
 /**
  * 用例描述: texture 的 target 是 GL_TEXTURE_RECTANGLE，origin 是 BottomLeft，当作遮罩绘制。
  */
@@ -18,6 +18,8 @@
 
 #include <base/utils/TimeUtil.h>
 #include "nlohmann/json.hpp"
+#include "rendering/caches/MaskCache.h"
+#include "rendering/renderers/MaskRenderer.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -304,4 +306,64 @@ PAG_TEST(PAGLayerTest, trackMatte_luma) {
   pagPlayer->flush();
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGLayerTest/trackMatte_luma"));
 }
+
+// Samples the coverage of both paths at the centers of a grid over their bounds, returns the number
+// of samples covered by only one of them.
+static int CountCoverageMismatches(const tgfx::Path& path, const tgfx::Path& expected) {
+  static constexpr int GridSize = 32;
+  auto bounds = path.getBounds();
+  bounds.join(expected.getBounds());
+  // Samples outside the bounds test the inverse fill types.
+  bounds.outset(bounds.width() * 0.1f, bounds.height() * 0.1f);
+  int mismatches = 0;
+  for (int y = 0; y < GridSize; y++) {
+    auto sampleY = bounds.top + bounds.height() * (static_cast<float>(y) + 0.5f) / GridSize;
+    for (int x = 0; x < GridSize; x++) {
+      auto sampleX = bounds.left + bounds.width() * (static_cast<float>(x) + 0.5f) / GridSize;
+      if (path.contains(sampleX, sampleY) != expected.contains(sampleX, sampleY)) {
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+
+/**
+ * 用例描述: MaskCache 增量合成的遮罩路径与每帧完整合成的结果一致
+ */
+PAG_TEST(PAGLayerTest, IncrementalMasks) {
+  for (auto& filePath : GetAllPAGFiles("resources/apitest")) {
+    auto file = File::Load(filePath);
+    ASSERT_TRUE(file != nullptr);
+    for (auto composition : file->compositions) {
+      if (composition->type() != CompositionType::Vector) {
+        continue;
+      }
+      for (auto layer : static_cast<VectorComposition*>(composition)->layers) {
+        if (layer->masks.empty()) {
+          continue;
+        }
+        MaskCache maskCache(layer);
+        // Visit the frames backwards, so the cached results of the later masks are reused.
+        for (auto frame = layer->duration - 1; frame >= 0; frame--) {
+          auto layerFrame = frame + layer->startTime;
+          tgfx::Path expected = {};
+          RenderMasks(&expected, layer->masks, layerFrame);
+          auto path = maskCache.createCache(layerFrame);
+          EXPECT_EQ(path->isInverseFillType(), expected.isInverseFillType());
+          auto bounds = path->getBounds();
+          auto expectedBounds = expected.getBounds();
+          EXPECT_NEAR(bounds.left, expectedBounds.left, 0.01f);
+          EXPECT_NEAR(bounds.top, expectedBounds.top, 0.01f);
+          EXPECT_NEAR(bounds.right, expectedBounds.right, 0.01f);
+          EXPECT_NEAR(bounds.bottom, expectedBounds.bottom, 0.01f);
+          // 合成顺序不同时路径的结构可能不同，逐像素比较覆盖范围。
+          EXPECT_EQ(CountCoverageMismatches(*path, expected), 0)
+              << filePath << " layer " << layer->id << " frame " << layerFrame;
+          delete path;
+        }
+      }
+    }
+  }
+}
 }  // namespace pag
@@ -16,7 +16,16 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <thread>
+#include "base/utils/TimeUtil.h"
 #include "nlohmann/json.hpp"
+#include "rendering/CompositionReader.h"
+#include "rendering/caches/LayerCache.h"
+#include "rendering/caches/MemoryBudgetManager.h"
+#include "rendering/layers/PAGStage.h"
+#include "rendering/utils/FrameBudgetGovernor.h"
+#include "rendering/utils/FrameSnapshot.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -129,4 +138,335 @@ PAG_TEST(PAGPlayerTest, autoClear) {
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGPlayerTest/autoClear_autoClear_true"));
 }
 
-}  // namespace pag
\ No newline at end of file
+/**
+ * 用例描述: PAGPlayer 并行录制子图层，渲染结果与顺序录制一致
+ */
+PAG_TEST(PAGPlayerTest, parallelRecording) {
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto parallelFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(parallelFile, nullptr);
+  // 编辑过的图层仍在当前线程录制。
+  parallelFile->getLayerAt(0)->setMatrix(Matrix::I());
+  pagFile->getLayerAt(0)->setMatrix(Matrix::I());
+  auto parallelSurface = OffscreenSurface::Make(parallelFile->width(), parallelFile->height());
+  auto parallelPlayer = std::make_unique<PAGPlayer>();
+  parallelPlayer->setSurface(parallelSurface);
+  parallelPlayer->setComposition(parallelFile);
+  EXPECT_FALSE(parallelPlayer->parallelRecordingEnabled());
+  parallelPlayer->setParallelRecordingEnabled(true);
+  EXPECT_TRUE(parallelPlayer->parallelRecordingEnabled());
+  EXPECT_TRUE(parallelPlayer->stage->parallelRecording());
+  // 未编辑的子合成内有多个子图层满足并行录制的条件，会分派到工作线程上录制。
+  auto childComposition = std::static_pointer_cast<PAGComposition>(parallelFile->getLayerAt(0));
+  EXPECT_FALSE(childComposition->contentModified());
+  EXPECT_FALSE(childComposition->layerCache->contentStatic());
+  size_t concurrentCount = 0;
+  for (auto& layer : childComposition->layers) {
+    if (layer->layerVisible && PAGComposition::CanRecordConcurrently(layer.get())) {
+      concurrentCount++;
+    }
+  }
+  EXPECT_GE(concurrentCount, 2lu);
+  for (int i = 0; i < 10; i++) {
+    pagPlayer->setProgress(i * 0.1);
+    pagPlayer->flush();
+    parallelPlayer->setProgress(i * 0.1);
+    parallelPlayer->flush();
+    auto bitmap = MakeSnapshot(pagSurface);
+    auto parallelBitmap = MakeSnapshot(parallelSurface);
+    Pixmap pixmap(bitmap);
+    Pixmap parallelPixmap(parallelBitmap);
+    ASSERT_EQ(pixmap.info().byteSize(), parallelPixmap.info().byteSize());
+    EXPECT_TRUE(memcmp(pixmap.pixels(), parallelPixmap.pixels(), pixmap.info().byteSize()) == 0);
+  }
+}
+
+static bool ContainsSequence(PAGLayer* layer) {
+  if (layer->layerType() != LayerType::PreCompose) {
+    return false;
+  }
+  auto type = static_cast<PreComposeLayer*>(layer->layer)->composition->type();
+  if (type == CompositionType::Video || type == CompositionType::Bitmap) {
+    return true;
+  }
+  for (auto& childLayer : static_cast<PAGComposition*>(layer)->layers) {
+    if (ContainsSequence(childLayer.get())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static PAGLayer* FindLayerWithSequenceMatte(PAGComposition* composition) {
+  for (auto& layer : composition->layers) {
+    auto trackMatteLayer = layer->_trackMatteLayer.get();
+    if (trackMatteLayer != nullptr && ContainsSequence(trackMatteLayer)) {
+      return layer.get();
+    }
+    if (layer->layerType() == LayerType::PreCompose) {
+      auto found = FindLayerWithSequenceMatte(static_cast<PAGComposition*>(layer.get()));
+      if (found != nullptr) {
+        return found;
+      }
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * 用例描述: 遮罩为序列帧的图层不会并行录制，渲染结果与顺序录制一致
+ */
+PAG_TEST(PAGPlayerTest, parallelRecordingSequenceMatte) {
+  auto pagFile = LoadPAGFile("resources/apitest/video_sequence_as_mask.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto parallelFile = LoadPAGFile("resources/apitest/video_sequence_as_mask.pag");
+  ASSERT_NE(parallelFile, nullptr);
+  // 序列帧的绘制结果缓存在 PAGStage 上，不能在工作线程上访问。
+  auto maskedLayer = FindLayerWithSequenceMatte(parallelFile.get());
+  ASSERT_NE(maskedLayer, nullptr);
+  EXPECT_FALSE(PAGComposition::CanRecordConcurrently(maskedLayer));
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto parallelSurface = OffscreenSurface::Make(parallelFile->width(), parallelFile->height());
+  auto parallelPlayer = std::make_unique<PAGPlayer>();
+  parallelPlayer->setSurface(parallelSurface);
+  parallelPlayer->setComposition(parallelFile);
+  parallelPlayer->setParallelRecordingEnabled(true);
+  for (int i = 0; i < 5; i++) {
+    pagPlayer->setProgress(i * 0.2);
+    pagPlayer->flush();
+    parallelPlayer->setProgress(i * 0.2);
+    parallelPlayer->flush();
+    auto bitmap = MakeSnapshot(pagSurface);
+    auto parallelBitmap = MakeSnapshot(parallelSurface);
+    Pixmap pixmap(bitmap);
+    Pixmap parallelPixmap(parallelBitmap);
+    ASSERT_EQ(pixmap.info().byteSize(), parallelPixmap.info().byteSize());
+    EXPECT_TRUE(memcmp(pixmap.pixels(), parallelPixmap.pixels(), pixmap.info().byteSize()) == 0);
+  }
+}
+
+/**
+ * 用例描述: PAGPlayer flush 过程中其他线程查询属性不等待rootLocker，返回当前帧的快照
+ */
+PAG_TEST(PAGPlayerTest, FrameSnapshot) {
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  std::atomic<double> expectedProgress = {-1};
+  std::atomic_int snapshotReads = {0};
+  std::atomic_int mismatchedReads = {0};
+  std::atomic_bool finished = {false};
+  std::thread renderer([&]() {
+    auto totalFrames =
+        std::max(static_cast<int>(pagFile->frameRate() * pagFile->duration() / 1000000), 1);
+    for (int i = 0; i < 300 && snapshotReads < 10; i++) {
+      // 每帧都修改进度，flush 时需要重新录制内容。
+      pagPlayer->setProgress(static_cast<double>(i % totalFrames) / totalFrames);
+      expectedProgress = pagPlayer->getProgress();
+      pagPlayer->flush();
+    }
+    finished = true;
+  });
+  while (!finished) {
+    auto snapshot = pagPlayer->snapshotHolder->renderingSnapshot();
+    if (snapshot == nullptr) {
+      continue;
+    }
+    auto progress = pagPlayer->getProgress();
+    auto duration = pagPlayer->duration();
+    // 快照仍是同一个说明查询在这一次 flush 结束前就返回了，没有等待 rootLocker。
+    if (pagPlayer->snapshotHolder->renderingSnapshot() != snapshot) {
+      continue;
+    }
+    snapshotReads++;
+    if (progress != expectedProgress || progress != snapshot->progress ||
+        duration != pagFile->duration()) {
+      mismatchedReads++;
+    }
+  }
+  renderer.join();
+  EXPECT_GT(snapshotReads, 0);
+  EXPECT_EQ(mismatchedReads, 0);
+
+  // 渲染结束后恢复读取实时的属性。
+  EXPECT_EQ(pagPlayer->snapshotHolder->renderingSnapshot(), nullptr);
+  EXPECT_EQ(pagPlayer->currentFrame(), pagFile->currentFrame());
+}
+
+/**
+ * 用例描述: PAGPlayer 帧耗时超出预算时逐级降低渲染质量，恢复余量后逐级还原
+ */
+PAG_TEST(PAGPlayerTest, FrameBudget) {
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  std::vector<int> levels = {};
+  pagPlayer->setQualityLevelCallback([&](int level) { levels.push_back(level); });
+  EXPECT_EQ(pagPlayer->frameBudget(), 0);
+  EXPECT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->qualityLevel(), PAGQualityLevel::Full);
+
+  // 1 微秒的预算，每一帧都会超出。
+  pagPlayer->setFrameBudget(1);
+  for (int i = 0; i < 12; i++) {
+    pagPlayer->setProgress(i * 0.05);
+    EXPECT_TRUE(pagPlayer->flush());
+  }
+  EXPECT_EQ(pagPlayer->qualityLevel(), PAGQualityLevel::LowFrameRate);
+  EXPECT_EQ(levels, std::vector<int>({1, 2, 3}));
+  EXPECT_FALSE(pagPlayer->renderCache->expensiveFiltersEnabled());
+  EXPECT_EQ(pagPlayer->stage->cacheScaleFactor, 0.5f);
+  EXPECT_EQ(pagPlayer->cacheScale(), 1.0f);
+  EXPECT_EQ(pagPlayer->maxFrameRate(), 60);
+
+  pagPlayer->setFrameBudget(0);
+  EXPECT_EQ(pagPlayer->qualityLevel(), PAGQualityLevel::Full);
+  EXPECT_EQ(levels.back(), PAGQualityLevel::Full);
+  EXPECT_TRUE(pagPlayer->renderCache->expensiveFiltersEnabled());
+  EXPECT_EQ(pagPlayer->stage->cacheScaleFactor, 1.0f);
+
+  // 迟滞：偶尔超出预算不降级，余量需持续一段时间才恢复。
+  FrameBudgetGovernor governor = {};
+  governor.setFrameBudget(10000);
+  EXPECT_FALSE(governor.recordFrame(20000));
+  EXPECT_FALSE(governor.recordFrame(20000));
+  EXPECT_FALSE(governor.recordFrame(8000));
+  EXPECT_FALSE(governor.recordFrame(20000));
+  EXPECT_EQ(governor.qualityLevel(), PAGQualityLevel::Full);
+  EXPECT_FALSE(governor.recordFrame(20000));
+  EXPECT_TRUE(governor.recordFrame(20000));
+  EXPECT_EQ(governor.qualityLevel(), PAGQualityLevel::LowCacheScale);
+  for (int i = 0; i < 29; i++) {
+    EXPECT_FALSE(governor.recordFrame(1000));
+  }
+  EXPECT_TRUE(governor.recordFrame(1000));
+  EXPECT_EQ(governor.qualityLevel(), PAGQualityLevel::Full);
+}
+
+/**
+ * 用例描述: 按预测显存进行播放器准入、预清理缓存，预测值与 CalculateGraphicsMemory 一致
+ */
+PAG_TEST(PAGPlayerTest, MemoryBudget) {
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto memories = CalculateGraphicsMemoriesPerFrame(pagFile->getFile());
+  ASSERT_FALSE(memories.empty());
+  EXPECT_EQ(*std::max_element(memories.begin(), memories.end()),
+            CalculateGraphicsMemory(pagFile->getFile()));
+
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setProgress(0.5);
+  auto frame = ProgressToFrame(0.5, static_cast<Frame>(memories.size()));
+  EXPECT_EQ(pagPlayer->predictedGraphicsMemory(), memories[static_cast<size_t>(frame)]);
+
+  // 未设置预算时也会登记，之后设置预算不影响已经活跃的播放器。
+  auto globalManager = MemoryBudgetManager::GetInstance();
+  EXPECT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(globalManager->entries.count(pagPlayer.get()), 1lu);
+  PAGMemoryBudget::SetBudget(1);
+  pagPlayer->setProgress(0.6);
+  EXPECT_TRUE(pagPlayer->flush());
+  EXPECT_TRUE(pagPlayer->memoryBudgetAdmitted());
+  EXPECT_EQ(globalManager->entries[pagPlayer.get()].peakMemory, pagPlayer->predictedPeakMemory);
+  pagPlayer->setSurface(nullptr);
+  EXPECT_EQ(globalManager->entries.count(pagPlayer.get()), 0lu);
+  pagPlayer->setSurface(pagSurface);
+  EXPECT_TRUE(pagPlayer->flush());
+  pagPlayer->setComposition(nullptr);
+  EXPECT_EQ(globalManager->entries.count(pagPlayer.get()), 0lu);
+  PAGMemoryBudget::SetBudget(0);
+
+  MemoryBudgetManager manager = {};
+  int ownerA = 0;
+  int ownerB = 0;
+  int ownerC = 0;
+  int preloadA = 0;
+  int preloadB = 0;
+  manager.setBudget(100);
+  // 没有其他活跃播放器时总是准入。
+  EXPECT_TRUE(manager.admit(&ownerA, 150));
+  EXPECT_FALSE(manager.admit(&ownerB, 10));
+  manager.release(&ownerA);
+  EXPECT_TRUE(manager.admit(&ownerA, 40));
+  EXPECT_TRUE(manager.admit(&ownerB, 30));
+  EXPECT_FALSE(manager.admit(&ownerC, 40));
+  EXPECT_EQ(manager.activeCount(), 2u);
+
+  // 预加载会占用预算，并发的预加载相互计入。
+  EXPECT_TRUE(manager.reserve(&preloadA, 20));
+  EXPECT_FALSE(manager.reserve(&preloadB, 20));
+  manager.release(&preloadA);
+  EXPECT_TRUE(manager.reserve(&preloadB, 20));
+  manager.release(&preloadB);
+
+  // B 的下一帧将超出预算，最久未刷新的 A 被要求清理缓存。
+  manager.update(&ownerA, 40, 40);
+  manager.update(&ownerB, 30, 70);
+  EXPECT_TRUE(manager.takePurgeRequest(&ownerA));
+  EXPECT_FALSE(manager.takePurgeRequest(&ownerA));
+  EXPECT_FALSE(manager.takePurgeRequest(&ownerB));
+
+  // 长时间未刷新的播放器释放占用的预算，预加载的占用不会过期。
+  EXPECT_TRUE(manager.reserve(&preloadA, 20));
+  manager.entries[&ownerA].lastActiveTime -= std::chrono::seconds(3);
+  manager.entries[&preloadA].lastActiveTime -= std::chrono::seconds(3);
+  EXPECT_TRUE(manager.admit(&ownerC, 40));
+  EXPECT_EQ(manager.entries.count(&ownerA), 0lu);
+  EXPECT_EQ(manager.entries.count(&preloadA), 1lu);
+  EXPECT_EQ(manager.predictedUsage(), 90);
+}
+
+/**
+ * 用例描述: 显存预算已被其他播放器占满时，PAGDecoder 仍然可以解码，内部播放器不计入活跃播放器
+ */
+PAG_TEST(PAGPlayerTest, MemoryBudgetDecoder) {
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  PAGMemoryBudget::SetBudget(1);
+  // 没有其他活跃播放器时总是准入，之后预算已经被占满。
+  EXPECT_TRUE(pagPlayer->flush());
+  EXPECT_TRUE(pagPlayer->memoryBudgetAdmitted());
+  auto activePlayers = PAGMemoryBudget::ActivePlayers();
+
+  auto decoderFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(decoderFile, nullptr);
+  auto decoder = PAGDecoder::MakeFrom(decoderFile, 30, 0.5f);
+  ASSERT_NE(decoder, nullptr);
+  // 关闭磁盘缓存，每一帧都经过内部播放器渲染。
+  decoder->setCacheKeyGeneratorFun(
+      [](PAGDecoder*, std::shared_ptr<PAGComposition>) { return std::string(); });
+  auto rowBytes = static_cast<size_t>(decoder->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * static_cast<size_t>(decoder->height()));
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(decoder->readFrame(i, pixels.data(), rowBytes));
+  }
+  ASSERT_NE(decoder->reader, nullptr);
+  auto globalManager = MemoryBudgetManager::GetInstance();
+  EXPECT_EQ(globalManager->entries.count(decoder->reader->pagPlayer), 0lu);
+  EXPECT_TRUE(decoder->reader->pagPlayer->memoryBudgetAdmitted());
+  EXPECT_EQ(PAGMemoryBudget::ActivePlayers(), activePlayers);
+  PAGMemoryBudget::SetBudget(0);
+}
+
+}  // namespace pag
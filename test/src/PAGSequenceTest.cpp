@@ -16,10 +16,19 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <thread>
 #include "codec/mp4/MP4BoxHelper.h"
+#include "ffavc.h"
 #include "pag/pag.h"
 #include "platform/swiftshader/NativePlatform.h"
 #include "rendering/caches/RenderCache.h"
+#include "rendering/sequences/BitmapSequenceReader.h"
+#include "rendering/sequences/SequenceInfo.h"
+#include "rendering/sequences/VideoReader.h"
+#include "rendering/video/SoftAVCDecoder.h"
+#include "rendering/video/SoftwareDecoderWrapper.h"
+#include "rendering/video/VideoDecoderPool.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -41,6 +50,270 @@ PAG_TEST(PAGSequenceTest, RenderOnScreen) {
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSequenceTest/pagSequenceTest"));
 }
 
+/**
+ * 用例描述: 视频序列帧预解码多帧时，渲染结果与逐帧解码一致
+ */
+PAG_TEST(PAGSequenceTest, VideoDecodeAhead) {
+  auto pagFile = LoadPAGFile("resources/apitest/wz_mvp.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto aheadFile = LoadPAGFile("resources/apitest/wz_mvp.pag");
+  ASSERT_NE(aheadFile, nullptr);
+  auto aheadSurface = OffscreenSurface::Make(aheadFile->width(), aheadFile->height());
+  auto aheadPlayer = std::make_shared<PAGPlayer>();
+  aheadPlayer->setSurface(aheadSurface);
+  aheadPlayer->setComposition(aheadFile);
+  aheadPlayer->setVideoDecodeAheadFrames(4);
+  EXPECT_EQ(aheadPlayer->videoDecodeAheadFrames(), 4);
+  for (int i = 0; i < 10; i++) {
+    pagPlayer->nextFrame();
+    pagPlayer->flush();
+    aheadPlayer->nextFrame();
+    aheadPlayer->flush();
+  }
+  // 下一帧在被请求之前已经在后台解码完成，请求时直接从队列中取出。
+  auto& sequenceCaches = aheadPlayer->renderCache->sequenceCaches;
+  ASSERT_EQ(sequenceCaches.size(), 1lu);
+  auto queue = sequenceCaches.begin()->second.front();
+  ASSERT_EQ(queue->decodeAheadFrames, 4lu);
+  ASSERT_NE(queue->decodeTask, nullptr);
+  queue->decodeTask->wait();
+  std::vector<Frame> readyFrames = {};
+  {
+    std::lock_guard<std::mutex> autoLock(queue->bufferLocker);
+    for (auto& item : queue->aheadBuffers) {
+      readyFrames.push_back(item.first);
+    }
+  }
+  ASSERT_GT(readyFrames.size(), 1lu);
+  EXPECT_EQ(readyFrames.front(), queue->nextFrameOf(queue->currentFrame));
+  auto lastFrame = queue->currentFrame;
+  for (int i = 0; i < 10 && queue->currentFrame == lastFrame; i++) {
+    aheadPlayer->nextFrame();
+    aheadPlayer->flush();
+  }
+  ASSERT_NE(queue->currentFrame, lastFrame);
+  EXPECT_NE(std::find(readyFrames.begin(), readyFrames.end(), queue->currentFrame),
+            readyFrames.end());
+  // seek backward.
+  pagPlayer->setProgress(0.1);
+  pagPlayer->flush();
+  aheadPlayer->setProgress(0.1);
+  aheadPlayer->flush();
+  auto bitmap = MakeSnapshot(pagSurface);
+  auto aheadBitmap = MakeSnapshot(aheadSurface);
+  tgfx::Pixmap pixmap(bitmap);
+  tgfx::Pixmap aheadPixmap(aheadBitmap);
+  ASSERT_EQ(pixmap.info().byteSize(), aheadPixmap.info().byteSize());
+  EXPECT_TRUE(memcmp(pixmap.pixels(), aheadPixmap.pixels(), pixmap.info().byteSize()) == 0);
+}
+
+/**
+ * 用例描述: 带透明通道的视频序列帧预解码多帧时，预解码的帧同样合成透明通道，渲染结果与逐帧解码一致
+ */
+PAG_TEST(PAGSequenceTest, AlphaVideoDecodeAhead) {
+  auto hasAlphaVideo = [](std::shared_ptr<PAGFile> pagFile) {
+    for (auto composition : pagFile->getFile()->compositions) {
+      if (composition->type() != CompositionType::Video) {
+        continue;
+      }
+      for (auto sequence : static_cast<VideoComposition*>(composition)->sequences) {
+        if (sequence->alphaStartX > 0 || sequence->alphaStartY > 0) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+  std::string path = "";
+  for (auto& name : {"video_sequence_test.pag", "video_sequence_as_mask.pag",
+                     "video_sequence_size.pag", "wz_mvp.pag"}) {
+    auto candidate = LoadPAGFile(std::string("resources/apitest/") + name);
+    if (candidate != nullptr && hasAlphaVideo(candidate)) {
+      path = std::string("resources/apitest/") + name;
+      break;
+    }
+  }
+  ASSERT_FALSE(path.empty());
+  auto pagFile = LoadPAGFile(path);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto aheadFile = LoadPAGFile(path);
+  auto aheadSurface = OffscreenSurface::Make(aheadFile->width(), aheadFile->height());
+  auto aheadPlayer = std::make_shared<PAGPlayer>();
+  aheadPlayer->setSurface(aheadSurface);
+  aheadPlayer->setComposition(aheadFile);
+  aheadPlayer->setVideoDecodeAheadFrames(4);
+  for (int i = 0; i < 5; i++) {
+    pagPlayer->nextFrame();
+    pagPlayer->flush();
+    aheadPlayer->nextFrame();
+    aheadPlayer->flush();
+    auto bitmap = MakeSnapshot(pagSurface);
+    auto aheadBitmap = MakeSnapshot(aheadSurface);
+    tgfx::Pixmap pixmap(bitmap);
+    tgfx::Pixmap aheadPixmap(aheadBitmap);
+    ASSERT_EQ(pixmap.info().byteSize(), aheadPixmap.info().byteSize());
+    EXPECT_TRUE(memcmp(pixmap.pixels(), aheadPixmap.pixels(), pixmap.info().byteSize()) == 0);
+  }
+  // 预解码的帧按序列尺寸输出，而不是包含透明通道区域的原始视频尺寸。
+  size_t aheadQueues = 0;
+  for (auto& item : aheadPlayer->renderCache->sequenceCaches) {
+    for (auto queue : item.second) {
+      if (queue->decodeAheadFrames <= 1 || queue->currentImage == nullptr) {
+        continue;
+      }
+      aheadQueues++;
+      EXPECT_EQ(queue->currentImage->width(), queue->sequence->width());
+      EXPECT_EQ(queue->currentImage->height(), queue->sequence->height());
+    }
+  }
+  EXPECT_GT(aheadQueues, 0lu);
+}
+
+class EmptySoftwareDecoder : public SoftwareDecoder {
+ public:
+  bool onConfigure(const std::vector<HeaderData>&, std::string, int, int) override {
+    return true;
+  }
+
+  DecoderResult onSendBytes(void*, size_t, int64_t) override {
+    return DecoderResult::Success;
+  }
+
+  DecoderResult onDecodeFrame() override {
+    return DecoderResult::TryAgainLater;
+  }
+
+  DecoderResult onEndOfStream() override {
+    return DecoderResult::Success;
+  }
+
+  void onFlush() override {
+  }
+
+  std::unique_ptr<YUVBuffer> onRenderFrame() override {
+    return nullptr;
+  }
+};
+
+static std::unique_ptr<VideoDecoder> MakeEmptyDecoder(const VideoFormat& format) {
+  return SoftwareDecoderWrapper::Wrap(std::make_shared<EmptySoftwareDecoder>(), format);
+}
+
+/**
+ * 用例描述: 解码器池复用相同格式的空闲解码器，空闲超时的解码器在播放器 flush 时即被释放
+ */
+PAG_TEST(PAGSequenceTest, VideoDecoderPool) {
+  auto decoderPool = VideoDecoderPool::GetInstance();
+  auto factory = VideoDecoderFactory::ExternalDecoderFactory();
+  VideoFormat format = {};
+  format.width = 100;
+  format.height = 100;
+  VideoFormat otherFormat = format;
+  otherFormat.width = 200;
+
+  auto decoder = MakeEmptyDecoder(format);
+  ASSERT_NE(decoder, nullptr);
+  auto decoderAddress = decoder.get();
+  decoderPool->recycle(factory, format, std::move(decoder));
+  EXPECT_EQ(decoderPool->obtain(factory, otherFormat), nullptr);
+  EXPECT_EQ(decoderPool->obtain(VideoDecoderFactory::SoftwareAVCDecoderFactory(), format), nullptr);
+  decoder = decoderPool->obtain(factory, format);
+  EXPECT_EQ(decoder.get(), decoderAddress);
+  EXPECT_EQ(decoderPool->obtain(factory, format), nullptr);
+
+  // 超过空闲时间的解码器无需等待下一次 obtain() 或 recycle() 即可被释放。
+  decoderPool->recycle(factory, format, std::move(decoder));
+  decoderPool->setMaxIdleTime(0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  decoderPool->purgeExpiredDecoders();
+  decoderPool->setMaxIdleTime(5000000);
+  EXPECT_EQ(decoderPool->obtain(factory, format), nullptr);
+
+  // 播放器每次 flush 结束时都会释放超时的解码器。
+  decoderPool->recycle(factory, format, MakeEmptyDecoder(format));
+  decoderPool->setMaxIdleTime(0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->flush();
+  decoderPool->setMaxIdleTime(5000000);
+  EXPECT_EQ(decoderPool->obtain(factory, format), nullptr);
+
+  // 关闭复用后回收的解码器直接释放。
+  PAGVideoDecoder::SetMaxPooledDecoderCount(0);
+  decoderPool->recycle(factory, format, MakeEmptyDecoder(format));
+  EXPECT_EQ(decoderPool->obtain(factory, format), nullptr);
+  PAGVideoDecoder::SetMaxPooledDecoderCount(4);
+}
+
+#ifdef PAG_USE_LIBAVC
+static int GetSoftwareDecoderThreadCount(PAGPlayer* pagPlayer) {
+  auto& sequenceCaches = pagPlayer->renderCache->sequenceCaches;
+  if (sequenceCaches.size() != 1) {
+    return 0;
+  }
+  auto reader = static_cast<VideoReader*>(sequenceCaches.begin()->second.front()->reader.get());
+  if (reader->videoDecoder == nullptr) {
+    return 0;
+  }
+  auto decoder = static_cast<SoftwareDecoderWrapper*>(reader->videoDecoder)->softwareDecoder;
+  return static_cast<SoftAVCDecoder*>(decoder.get())->numCores;
+}
+
+/**
+ * 用例描述: 内置软解码器(libavc)按设置的线程数创建，多线程解码的结果与单线程一致
+ */
+PAG_TEST(PAGSequenceTest, SoftwareDecoderThreads) {
+  // 只使用内置的 libavc 解码器，并且不复用其他线程数下创建的解码器。
+  PAGVideoDecoder::RegisterSoftwareDecoderFactory(nullptr);
+  PAGVideoDecoder::SetMaxPooledDecoderCount(0);
+  auto renderFrame = [](int threadCount, std::shared_ptr<PAGPlayer>* player) {
+    PAGVideoDecoder::SetSoftwareDecoderThreadCount(threadCount);
+    auto pagFile = LoadPAGFile("resources/apitest/wz_mvp.pag");
+    auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+    auto pagPlayer = std::make_shared<PAGPlayer>();
+    pagPlayer->setSurface(pagSurface);
+    pagPlayer->setComposition(pagFile);
+    pagPlayer->setProgress(0.5);
+    pagPlayer->flush();
+    *player = pagPlayer;
+    return MakeSnapshot(pagSurface);
+  };
+  std::shared_ptr<PAGPlayer> pagPlayer = nullptr;
+  auto bitmap = renderFrame(1, &pagPlayer);
+  auto threadCount = GetSoftwareDecoderThreadCount(pagPlayer.get());
+  std::shared_ptr<PAGPlayer> threadPlayer = nullptr;
+  auto threadBitmap = renderFrame(2, &threadPlayer);
+  auto multiThreadCount = GetSoftwareDecoderThreadCount(threadPlayer.get());
+  std::shared_ptr<PAGPlayer> clampedPlayer = nullptr;
+  renderFrame(8, &clampedPlayer);
+  auto clampedThreadCount = GetSoftwareDecoderThreadCount(clampedPlayer.get());
+  PAGVideoDecoder::SetSoftwareDecoderThreadCount(1);
+  PAGVideoDecoder::SetMaxPooledDecoderCount(4);
+  PAGVideoDecoder::RegisterSoftwareDecoderFactory(
+      reinterpret_cast<SoftwareDecoderFactory*>(ffavc::DecoderFactory::GetHandle()));
+
+  EXPECT_EQ(threadCount, 1);
+  EXPECT_EQ(multiThreadCount, 2);
+  EXPECT_EQ(clampedThreadCount, 4);
+  tgfx::Pixmap pixmap(bitmap);
+  tgfx::Pixmap threadPixmap(threadBitmap);
+  ASSERT_EQ(pixmap.info().byteSize(), threadPixmap.info().byteSize());
+  EXPECT_TRUE(memcmp(pixmap.pixels(), threadPixmap.pixels(), pixmap.info().byteSize()) == 0);
+}
+#endif
+
 /**
  * 用例描述: bitmapSequence关键帧不是全屏的时候要清屏
  */
@@ -57,6 +330,147 @@ PAG_TEST(PAGSequenceTest, BitmapSequenceReader) {
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSequenceTest/BitmapSequenceReader"));
 }
 
+/**
+ * 用例描述: 位图序列帧跳帧解码时跳过被完全覆盖的位图，结果与逐帧解码一致
+ */
+PAG_TEST(PAGSequenceTest, BitmapSequenceSeek) {
+  auto file = File::Load(ProjectPath::Absolute("resources/apitest/ZC_mg_seky2_landscape.pag"));
+  ASSERT_TRUE(file != nullptr);
+  BitmapSequence* sequence = nullptr;
+  for (auto composition : file->compositions) {
+    if (composition->type() == CompositionType::Bitmap) {
+      sequence = static_cast<BitmapSequence*>(Sequence::Get(composition));
+      break;
+    }
+  }
+  ASSERT_TRUE(sequence != nullptr);
+  auto sequenceInfo = SequenceInfo::Make(sequence);
+  auto sequentialReader =
+      std::static_pointer_cast<BitmapSequenceReader>(sequenceInfo->makeReader(file));
+  auto seekingReader =
+      std::static_pointer_cast<BitmapSequenceReader>(sequenceInfo->makeReader(file));
+  ASSERT_TRUE(sequentialReader != nullptr && seekingReader != nullptr);
+  Frame sequentialFrame = 0;
+  for (Frame frame = 0; frame < sequence->duration(); frame += 7) {
+    for (; sequentialFrame <= frame; sequentialFrame++) {
+      ASSERT_TRUE(sequentialReader->readBuffer(sequentialFrame) != nullptr);
+    }
+    ASSERT_TRUE(seekingReader->readBuffer(frame) != nullptr);
+    // 使用硬件缓存时无法直接比较像素。
+    if (sequentialReader->pixels != nullptr && seekingReader->pixels != nullptr) {
+      auto& pixels = sequentialReader->pixels;
+      EXPECT_EQ(memcmp(pixels->data(), seekingReader->pixels->data(), pixels->size()), 0)
+          << "frame " << frame;
+    }
+  }
+
+  // 后面的帧重复绘制关键帧的位图时，前面被完全覆盖的位图不再解码。
+  auto keyframe = sequence->frames[0];
+  ASSERT_TRUE(keyframe->isKeyframe);
+  ASSERT_FALSE(keyframe->bitmaps.empty());
+  BitmapSequence repeatedSequence = {};
+  repeatedSequence.width = sequence->width;
+  repeatedSequence.height = sequence->height;
+  for (int i = 0; i < 3; i++) {
+    auto bitmapFrame = new BitmapFrame();
+    bitmapFrame->isKeyframe = i == 0;
+    bitmapFrame->bitmaps = keyframe->bitmaps;
+    repeatedSequence.frames.push_back(bitmapFrame);
+  }
+  seekingReader->sequence = &repeatedSequence;
+  auto bitmaps = seekingReader->collectVisibleBitmaps(0, 2);
+  seekingReader->sequence = sequence;
+  // 位图属于原始的文件，不能被重复释放。
+  for (auto bitmapFrame : repeatedSequence.frames) {
+    bitmapFrame->bitmaps.clear();
+  }
+  EXPECT_FALSE(bitmaps.empty());
+  EXPECT_LE(bitmaps.size(), keyframe->bitmaps.size());
+}
+
+static std::shared_ptr<PAGLayer> FindSequenceLayer(PAGComposition* composition) {
+  for (auto& layer : composition->layers) {
+    if (layer->layerType() != LayerType::PreCompose) {
+      continue;
+    }
+    auto type = static_cast<PreComposeLayer*>(layer->layer)->composition->type();
+    if (type == CompositionType::Bitmap || type == CompositionType::Video) {
+      return layer;
+    }
+    auto sequenceLayer = FindSequenceLayer(static_cast<PAGComposition*>(layer.get()));
+    if (sequenceLayer != nullptr) {
+      return sequenceLayer;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * 用例描述: 序列帧的像素级碰撞检测使用当前帧的 AlphaMask，同一帧内复用，切换帧后重新生成
+ */
+PAG_TEST(PAGSequenceTest, SequencePixelHitTest) {
+  auto pagFile = LoadPAGFile("resources/apitest/bitmap_sequence_test.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto sequenceLayer = FindSequenceLayer(pagFile.get());
+  ASSERT_NE(sequenceLayer, nullptr);
+  // 只保留序列帧图层，绘制出的像素都来自序列帧。
+  auto composition = PAGComposition::Make(pagFile->width(), pagFile->height());
+  composition->addLayer(sequenceLayer);
+  sequenceLayer->setStartTime(0);
+  auto pagSurface = OffscreenSurface::Make(composition->width(), composition->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(composition);
+  pagPlayer->setProgress(0.5);
+  pagPlayer->flush();
+  auto& sequenceCaches = pagPlayer->renderCache->sequenceCaches;
+  ASSERT_EQ(sequenceCaches.size(), 1lu);
+  auto queue = sequenceCaches.begin()->second.front();
+  EXPECT_EQ(queue->alphaMask, nullptr);
+
+  auto bitmap = MakeSnapshot(pagSurface);
+  tgfx::Pixmap pixmap(bitmap);
+  ASSERT_FALSE(pixmap.isEmpty());
+  auto pixels = reinterpret_cast<const uint8_t*>(pixmap.pixels());
+  int sampleCount = 0;
+  int hitCount = 0;
+  int mismatchCount = 0;
+  tgfx::Point hitPoint = {};
+  for (int y = 0; y < pixmap.height(); y += 7) {
+    for (int x = 0; x < pixmap.width(); x += 7) {
+      auto alpha = pixels[y * pixmap.rowBytes() + x * 4 + 3];
+      auto hit = pagPlayer->hitTestPoint(sequenceLayer, static_cast<float>(x) + 0.5f,
+                                         static_cast<float>(y) + 0.5f, true);
+      sampleCount++;
+      if (hit) {
+        hitCount++;
+        hitPoint.set(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f);
+      }
+      if (hit != (alpha > 0)) {
+        mismatchCount++;
+      }
+    }
+  }
+  EXPECT_GT(hitCount, 0);
+  // 图层可能带有缩放，只允许边缘上的少量采样点因为滤波不一致。
+  EXPECT_LE(mismatchCount * 20, sampleCount);
+  auto alphaMask = queue->alphaMask;
+  ASSERT_NE(alphaMask, nullptr);
+  EXPECT_EQ(queue->maskFrame, queue->currentFrame);
+
+  // 切换到下一帧后，碰撞检测为新的帧重新生成 AlphaMask。
+  auto lastFrame = queue->currentFrame;
+  for (int i = 0; i < 10 && queue->currentFrame == lastFrame; i++) {
+    pagPlayer->nextFrame();
+    pagPlayer->flush();
+  }
+  ASSERT_NE(queue->currentFrame, lastFrame);
+  EXPECT_EQ(queue->alphaMask, alphaMask);
+  pagPlayer->hitTestPoint(sequenceLayer, hitPoint.x, hitPoint.y, true);
+  EXPECT_NE(queue->alphaMask, alphaMask);
+  EXPECT_EQ(queue->maskFrame, queue->currentFrame);
+}
+
 /**
  * 用例描述: 视频序列帧作为遮罩
  */
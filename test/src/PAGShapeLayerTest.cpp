@@ -17,9 +17,307 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <fstream>
+#include "base/keyframes/PathKeyframe.h"
+#include "base/utils/Interpolate.h"
+#include "rendering/caches/RenderCache.h"
+#include "rendering/utils/LRUCache.h"
+#include "rendering/utils/PathMeasureCache.h"
+#include "rendering/utils/StrokeOutlineCache.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
+static void ExpectPathNear(const PathData& path, const PathData& expected) {
+  EXPECT_TRUE(path.verbs == expected.verbs);
+  ASSERT_EQ(path.points.size(), expected.points.size());
+  for (size_t i = 0; i < expected.points.size(); i++) {
+    EXPECT_NEAR(path.points[i].x, expected.points[i].x, 0.001f);
+    EXPECT_NEAR(path.points[i].y, expected.points[i].y, 0.001f);
+  }
+}
+
+/**
+ * 用例描述: 路径关键帧预先对齐顶点后的插值结果与 PathData::interpolate 一致，并复用输出的路径缓冲
+ */
+PAG_TEST(PAGShapeLayerTest, PathKeyframe) {
+  auto startPath = std::make_shared<PathData>();
+  startPath->moveTo(0, 0);
+  startPath->lineTo(100, 0);
+  startPath->lineTo(100, 100);
+  startPath->close();
+  auto endPath = std::make_shared<PathData>();
+  endPath->moveTo(10, 10);
+  endPath->cubicTo(40, -20, 80, 20, 120, 10);
+  endPath->lineTo(90, 120);
+  endPath->close();
+  PathKeyframe keyframe = {};
+  keyframe.startValue = startPath;
+  keyframe.endValue = endPath;
+  keyframe.startTime = 0;
+  keyframe.endTime = 10;
+  keyframe.interpolationType = KeyframeInterpolationType::Linear;
+  PathData startCopy = *startPath;
+  PathData endCopy = *endPath;
+  keyframe.initialize();
+  // 不同的顶点只对齐一次，对齐结果保存在关键帧上，解码出的原始路径保持不变。
+  EXPECT_TRUE(keyframe.alignedStart->verbs == keyframe.alignedEnd->verbs);
+  EXPECT_EQ(keyframe.alignedStart->points.size(), keyframe.alignedEnd->points.size());
+  EXPECT_EQ(keyframe.startValue, startPath);
+  EXPECT_EQ(keyframe.endValue, endPath);
+  ExpectPathNear(*startPath, startCopy);
+  ExpectPathNear(*endPath, endCopy);
+  for (Frame frame = keyframe.startTime; frame < keyframe.endTime; frame++) {
+    PathData expected = {};
+    startPath->interpolate(*endPath, &expected, keyframe.getProgress(frame));
+    ExpectPathNear(*keyframe.getValueAt(frame), expected);
+  }
+
+  // 释放后的结果被下一次采样复用，仍被持有的结果不会被覆盖。
+  auto first = keyframe.getValueAt(2).get();
+  EXPECT_EQ(keyframe.getValueAt(5).get(), first);
+  auto held = keyframe.getValueAt(2);
+  PathData heldCopy = *held;
+  auto next = keyframe.getValueAt(7);
+  EXPECT_NE(next.get(), held.get());
+  ExpectPathNear(*held, heldCopy);
+
+  // 顶点相同的路径直接插值，不额外复制。
+  auto samePath = std::make_shared<PathData>();
+  samePath->moveTo(0, 0);
+  samePath->lineTo(50, 50);
+  auto otherPath = std::make_shared<PathData>();
+  otherPath->moveTo(20, 0);
+  otherPath->lineTo(70, 30);
+  PathKeyframe sameKeyframe = {};
+  sameKeyframe.startValue = samePath;
+  sameKeyframe.endValue = otherPath;
+  sameKeyframe.startTime = 0;
+  sameKeyframe.endTime = 4;
+  sameKeyframe.interpolationType = KeyframeInterpolationType::Linear;
+  sameKeyframe.initialize();
+  EXPECT_EQ(sameKeyframe.alignedStart, samePath);
+  EXPECT_EQ(sameKeyframe.alignedEnd, otherPath);
+  PathData expected = {};
+  samePath->interpolate(*otherPath, &expected, 0.5f);
+  ExpectPathNear(*sameKeyframe.getValueAt(2), expected);
+}
+
+/**
+ * 用例描述: TrimPaths 复用缓存的路径长度表，裁剪结果与重新测量一致，动画路径不进入缓存
+ */
+PAG_TEST(PAGShapeLayerTest, TrimPathsMeasureCache) {
+  tgfx::Path path = {};
+  path.addOval(tgfx::Rect::MakeXYWH(10, 10, 200, 120));
+  path.moveTo(20, 300);
+  path.cubicTo(80, 180, 160, 420, 240, 300);
+  auto measuredPath = PathMeasureCache::Get(path);
+  auto pathCopy = path;
+  EXPECT_EQ(PathMeasureCache::Get(pathCopy), measuredPath);
+  auto pathMeasure = tgfx::PathMeasure::MakeFrom(path);
+  EXPECT_FLOAT_EQ(measuredPath->length(), pathMeasure->getLength());
+  for (int i = 1; i <= 10; i++) {
+    auto end = static_cast<float>(i) / 10;
+    tgfx::Path expected = {};
+    pathMeasure->getSegment(pathMeasure->getLength() * 0.1f, pathMeasure->getLength() * end,
+                            &expected);
+    tgfx::Path result = {};
+    measuredPath->getSegment(measuredPath->length() * 0.1f, measuredPath->length() * end,
+                             &result);
+    EXPECT_TRUE(result == expected);
+  }
+
+  tgfx::Path animatedPath = {};
+  animatedPath.addRect(tgfx::Rect::MakeXYWH(0, 0, 30, 40));
+  auto animatedMeasure = PathMeasureCache::Get(animatedPath, true);
+  EXPECT_NE(PathMeasureCache::Get(animatedPath, true), animatedMeasure);
+  auto staticMeasure = PathMeasureCache::Get(animatedPath);
+  EXPECT_NE(staticMeasure, animatedMeasure);
+  EXPECT_EQ(PathMeasureCache::Get(animatedPath), staticMeasure);
+}
+
+/**
+ * 用例描述: LRUCache 按内存上限淘汰最久未使用的条目，超过单个分片容量的条目不缓存
+ */
+PAG_TEST(PAGShapeLayerTest, LRUCache) {
+  LRUCache<int, int> cache(8 * 100);
+  for (int i = 0; i < 1000; i++) {
+    cache.add(i, i * 2, 10);
+  }
+  EXPECT_LE(cache.memoryUsage(), 800u);
+  EXPECT_GT(cache.memoryUsage(), 0u);
+  int value = 0;
+  EXPECT_TRUE(cache.find(999, &value));
+  EXPECT_EQ(value, 1998);
+  EXPECT_FALSE(cache.find(0, &value));
+  cache.add(2000, 1, 101);
+  EXPECT_FALSE(cache.find(2000, &value));
+  auto memoryUsage = cache.memoryUsage();
+  cache.add(999, 0, 10);
+  EXPECT_EQ(cache.memoryUsage(), memoryUsage);
+  EXPECT_TRUE(cache.find(999, &value));
+  EXPECT_EQ(value, 1998);
+  cache.setMaxMemory(8 * 20);
+  cache.add(3000, 1, 10);
+  EXPECT_LE(cache.memoryUsage(), memoryUsage);
+  EXPECT_TRUE(cache.find(3000, &value));
+
+  // 共享缓存在创建时和显存预算变化时同步内存上限。
+  auto sharedCache = RenderCache::MakeSharedCache<int, int>();
+  EXPECT_EQ(sharedCache->maxMemory, RenderCache::SharedCacheMemoryLimit());
+  PAGMemoryBudget::SetBudget(32 * 1024);
+  EXPECT_EQ(sharedCache->maxMemory, 1024u);
+  PAGMemoryBudget::SetBudget(0);
+  EXPECT_EQ(sharedCache->maxMemory, RenderCache::SharedCacheMemoryLimit());
+}
+
+/**
+ * 用例描述: 描边轮廓缓存，只有描边的几何参数完全一致时才命中
+ */
+PAG_TEST(PAGShapeLayerTest, StrokeOutlineCache) {
+  StrokeKey key = {};
+  key.path.addOval(tgfx::Rect::MakeXYWH(0, 0, 100, 80));
+  key.strokeWidth = 4;
+  key.lineCap = LineCap::Round;
+  key.lineJoin = LineJoin::Round;
+  key.miterLimit = 4;
+  key.dashes = {10, 5};
+  tgfx::Path outline = {};
+  outline.addRect(tgfx::Rect::MakeXYWH(-2, -2, 104, 84));
+  StrokeOutlineCache::Add(key, outline);
+  auto sameKey = key;
+  EXPECT_EQ(StrokeKeyHasher()(sameKey), StrokeKeyHasher()(key));
+  tgfx::Path result = {};
+  EXPECT_TRUE(StrokeOutlineCache::Find(sameKey, &result));
+  EXPECT_TRUE(result == outline);
+  auto otherKey = key;
+  otherKey.dashOffset = 1;
+  EXPECT_FALSE(StrokeOutlineCache::Find(otherKey, &result));
+  otherKey = key;
+  otherKey.matrix = tgfx::Matrix::MakeScale(2);
+  EXPECT_FALSE(StrokeOutlineCache::Find(otherKey, &result));
+  otherKey = key;
+  otherKey.path.lineTo(10, 10);
+  EXPECT_FALSE(StrokeOutlineCache::Find(otherKey, &result));
+  tgfx::Path largeOutline = {};
+  for (int i = 0; i < 9000; i++) {
+    largeOutline.lineTo(static_cast<float>(i), static_cast<float>(i % 2));
+  }
+  StrokeOutlineCache::Add(otherKey, largeOutline);
+  EXPECT_FALSE(StrokeOutlineCache::Find(otherKey, &result));
+}
+
+static std::unique_ptr<ShapeLayer> MakeShapeLayer(const std::vector<ShapeElement*>& contents) {
+  auto layer = std::make_unique<ShapeLayer>();
+  layer->transform = Transform2D::MakeDefault().release();
+  layer->duration = 10;
+  layer->contents = contents;
+  return layer;
+}
+
+static std::vector<ShapeElement*> MakeRepeatedShape(bool stroked) {
+  auto rectangle = new RectangleElement();
+  rectangle->size = new Property<Point>(Point::Make(40, 30));
+  rectangle->position = new Property<Point>(Point::Make(30, 25));
+  rectangle->roundness = new Property<float>(4.0f);
+  if (!stroked) {
+    auto fill = new FillElement();
+    fill->color = new Property<Color>(Red);
+    fill->opacity = new Property<Opacity>(Opaque);
+    return {rectangle, fill};
+  }
+  auto stroke = new StrokeElement();
+  stroke->color = new Property<Color>(Blue);
+  stroke->opacity = new Property<Opacity>(Opaque);
+  stroke->strokeWidth = new Property<float>(3.0f);
+  stroke->miterLimit = new Property<float>(4.0f);
+  stroke->dashOffset = new Property<float>(0.0f);
+  return {rectangle, stroke};
+}
+
+/**
+ * 分别用 Repeater 和逐个复制到分组的方式绘制同一个图形，返回两者像素的最大差值。
+ */
+static int CompareRepeaterWithCopies(bool stroked) {
+  const float copies = 4.0f;
+  const float offset = 0.5f;
+  const auto anchorPoint = Point::Make(30, 25);
+  const auto position = Point::Make(60, 10);
+  const auto scale = Point::Make(0.9f, 0.9f);
+  const float rotation = 15.0f;
+  const Opacity startOpacity = Opaque;
+  const Opacity endOpacity = 100;
+
+  auto repeater = new RepeaterElement();
+  repeater->copies = new Property<float>(copies);
+  repeater->offset = new Property<float>(offset);
+  repeater->transform = new RepeaterTransform();
+  repeater->transform->anchorPoint = new Property<Point>(anchorPoint);
+  repeater->transform->position = new Property<Point>(position);
+  repeater->transform->scale = new Property<Point>(scale);
+  repeater->transform->rotation = new Property<float>(rotation);
+  repeater->transform->startOpacity = new Property<Opacity>(startOpacity);
+  repeater->transform->endOpacity = new Property<Opacity>(endOpacity);
+  auto repeaterContents = MakeRepeatedShape(stroked);
+  repeaterContents.push_back(repeater);
+  auto repeaterLayer = MakeShapeLayer(repeaterContents);
+
+  // 每个副本的矩阵和透明度与 Repeater 的计算方式一致。
+  std::vector<ShapeElement*> copyContents = {};
+  for (float i = 0; i < copies; i++) {
+    auto progress = i + offset;
+    auto group = new ShapeGroupElement();
+    group->transform = new ShapeTransform();
+    group->transform->anchorPoint = new Property<Point>(anchorPoint);
+    group->transform->position = new Property<Point>(Point::Make(
+        anchorPoint.x + position.x * progress, anchorPoint.y + position.y * progress));
+    group->transform->scale = new Property<Point>(
+        Point::Make(powf(scale.x, progress), powf(scale.y, progress)));
+    group->transform->skew = new Property<float>(0.0f);
+    group->transform->skewAxis = new Property<float>(0.0f);
+    group->transform->rotation = new Property<float>(rotation * progress);
+    group->transform->opacity =
+        new Property<Opacity>(Interpolate(startOpacity, endOpacity, progress / copies));
+    group->elements = MakeRepeatedShape(stroked);
+    copyContents.push_back(group);
+  }
+  auto copyLayer = MakeShapeLayer(copyContents);
+
+  auto render = [](ShapeLayer* layer) {
+    auto pagLayer = std::make_shared<PAGShapeLayer>(nullptr, layer);
+    pagLayer->weakThis = pagLayer;
+    auto composition = PAGComposition::Make(400, 200);
+    composition->addLayer(pagLayer);
+    auto pagSurface = OffscreenSurface::Make(400, 200);
+    auto pagPlayer = std::make_unique<PAGPlayer>();
+    pagPlayer->setSurface(pagSurface);
+    pagPlayer->setComposition(composition);
+    pagPlayer->flush();
+    return MakeSnapshot(pagSurface);
+  };
+  auto bitmap = render(repeaterLayer.get());
+  auto copyBitmap = render(copyLayer.get());
+  tgfx::Pixmap pixmap(bitmap);
+  tgfx::Pixmap copyPixmap(copyBitmap);
+  if (pixmap.isEmpty() || pixmap.info().byteSize() != copyPixmap.info().byteSize()) {
+    return 255;
+  }
+  auto pixels = static_cast<const uint8_t*>(pixmap.pixels());
+  auto copyPixels = static_cast<const uint8_t*>(copyPixmap.pixels());
+  int maxDifference = 0;
+  for (size_t i = 0; i < pixmap.info().byteSize(); i++) {
+    maxDifference = std::max(maxDifference, abs(pixels[i] - copyPixels[i]));
+  }
+  return maxDifference;
+}
+
+/**
+ * 用例描述: Repeater 只记录一份几何数据并按每个副本的矩阵重复绘制，结果与逐个复制的图形一致
+ */
+PAG_TEST(PAGShapeLayerTest, RepeaterInstances) {
+  // 只允许抗锯齿边缘上的细微差异。
+  EXPECT_LE(CompareRepeaterWithCopies(false), 2);
+  // 描边随副本的矩阵一起缩放。
+  EXPECT_LE(CompareRepeaterWithCopies(true), 2);
+}
 
 /**
  * 用例描述: 测试 PolyStar-star
@@ -539,4 +539,64 @@ PAG_TEST(PAGTextLayerTest, TextLayerScaleAnimationWithMipmap) {
   EXPECT_TRUE(
       Baseline::Compare(TestPAGSurface, "PAGTextLayerTest/TextLayerScaleAnimationWithMipmap"));
 }
+
+static std::unique_ptr<TextRangeSelector> MakeRangeSelector(Enum shape, Enum mode,
+                                                            bool randomizeOrder) {
+  auto selector = std::make_unique<TextRangeSelector>();
+  selector->start = new Property<Percent>(0.15f);
+  selector->end = new Property<Percent>(0.8f);
+  selector->offset = new Property<float>(0.05f);
+  selector->mode = new Property<Enum>(mode);
+  selector->amount = new Property<Percent>(0.9f);
+  selector->shape = shape;
+  selector->smoothness = new Property<Percent>(1.0f);
+  selector->easeHigh = new Property<Percent>(0.3f);
+  selector->easeLow = new Property<Percent>(-0.2f);
+  selector->randomizeOrder = randomizeOrder;
+  selector->randomSeed = new Property<uint16_t>(7);
+  return selector;
+}
+
+static std::unique_ptr<TextWigglySelector> MakeWigglySelector(Enum mode) {
+  auto selector = std::make_unique<TextWigglySelector>();
+  selector->mode = new Property<Enum>(mode);
+  selector->maxAmount = new Property<Percent>(0.8f);
+  selector->minAmount = new Property<Percent>(-0.4f);
+  selector->wigglesPerSecond = new Property<float>(2.0f);
+  selector->correlation = new Property<Percent>(0.5f);
+  selector->temporalPhase = new Property<float>(10.0f);
+  selector->spatialPhase = new Property<float>(20.0f);
+  selector->lockDimensions = new Property<bool>(false);
+  selector->randomSeed = new Property<uint16_t>(3);
+  return selector;
+}
+
+/**
+ * 用例描述: 文本动画批量计算的范围因子与逐个字符计算的结果一致，覆盖所有的形状和叠加模式
+ */
+PAG_TEST(PAGTextLayerTest, TextAnimatorFactors) {
+  const size_t textCount = 23;
+  const Frame frame = 5;
+  for (Enum shape = TextRangeSelectorShape::Square; shape <= TextRangeSelectorShape::Smooth;
+       shape++) {
+    for (Enum mode = TextSelectorMode::Add; mode <= TextSelectorMode::Difference; mode++) {
+      auto firstSelector = MakeRangeSelector(shape, TextSelectorMode::Add, shape % 2 == 1);
+      auto secondSelector = MakeRangeSelector(TextRangeSelectorShape::Triangle, mode, false);
+      auto wigglySelector = MakeWigglySelector(mode);
+      RangeSelectorRenderer firstRenderer(firstSelector.get(), textCount, frame);
+      RangeSelectorRenderer secondRenderer(secondSelector.get(), textCount, frame);
+      WigglySelectorRenderer wigglyRenderer(wigglySelector.get(), textCount, frame);
+      std::vector<TextSelectorRenderer*> selectorRenderers = {&firstRenderer, &secondRenderer,
+                                                              &wigglyRenderer};
+      std::vector<float> factors = {};
+      TextSelectorRenderer::CalculateFactorsFromSelectors(selectorRenderers, textCount, &factors);
+      ASSERT_EQ(factors.size(), textCount);
+      for (size_t i = 0; i < textCount; i++) {
+        auto factor = TextSelectorRenderer::CalculateFactorFromSelectors(selectorRenderers, i);
+        EXPECT_FLOAT_EQ(factors[i], factor) << "shape " << static_cast<int>(shape) << " mode "
+                                            << static_cast<int>(mode) << " index " << i;
+      }
+    }
+  }
+}
 }  // namespace pag